@@ -79,23 +79,7 @@ namespace chinese_dark_chess
 	};
 
 	StateData::StateData() :
-		_hidden_pieces(
-	{
-		PIECE_RED_PAWN,PIECE_RED_PAWN,PIECE_RED_PAWN,PIECE_RED_PAWN,PIECE_RED_PAWN,
-		PIECE_RED_CANNON,PIECE_RED_CANNON,
-		PIECE_RED_KNIGHT,PIECE_RED_KNIGHT,
-		PIECE_RED_ROOK,PIECE_RED_ROOK,
-		PIECE_RED_MINISTER,PIECE_RED_MINISTER,
-		PIECE_RED_GUARD,PIECE_RED_GUARD,
-		PIECE_RED_KING,
-		PIECE_BLACK_PAWN,PIECE_BLACK_PAWN,PIECE_BLACK_PAWN,PIECE_BLACK_PAWN,PIECE_BLACK_PAWN,
-		PIECE_BLACK_CANNON,PIECE_BLACK_CANNON,
-		PIECE_BLACK_KNIGHT,PIECE_BLACK_KNIGHT,
-		PIECE_BLACK_ROOK,PIECE_BLACK_ROOK,
-		PIECE_BLACK_MINISTER,PIECE_BLACK_MINISTER,
-		PIECE_BLACK_GUARD,PIECE_BLACK_GUARD,
-		PIECE_BLACK_KING
-	}),
+		_hidden_pieces(g_CDC_BEGINING_HIDDEN),
 		_next_player(PLAYER_RED)
 	{
 		for (size_t x = 0; x < g_CDC_BOARD_WIDTH; x++)
@@ -113,9 +97,13 @@ namespace chinese_dark_chess
 	}
 
 	StateData::StateData(std::vector<std::vector<PieceType>> data, std::vector<PieceType> hidden_pieces, PlayerIndex next_player):
-		_hidden_pieces(hidden_pieces),
+		_hidden_pieces(),
 		_next_player(next_player)
 	{
+		for (auto p : hidden_pieces)
+		{
+			_hidden_pieces.push(p);
+		}
 		for (size_t y = 0; y < g_CDC_BOARD_HEIGHT; y++)
 		{
 			for (size_t x = 0; x < g_CDC_BOARD_WIDTH; x++)
@@ -146,25 +134,27 @@ namespace chinese_dark_chess
 				}
 			}
 		}
-		_hidden_pieces.clear();
-		for (size_t i = 0; i < state.hidden_pieces().upper_bound(); i++)
+		_hidden_pieces = state.hidden_pieces();
+		_next_player = state.next_player();
+	}
+
+	//get hidden pieces.
+	std::vector<PieceType> StateData::hidden_pieces() const
+	{
+		std::vector<PieceType> pieces;
+		for (size_t i = 0; i < _hidden_pieces.upper_bound(); i++)
 		{
-			for (size_t n = 0; n < state.hidden_pieces()[i]; n++)
+			for (size_t n = 0; n < _hidden_pieces[i]; n++)
 			{
-				_hidden_pieces.push_back((PieceType)i);
+				pieces.push_back((PieceType)i);
 			}
 		}
-		_next_player = state.next_player();
+		return pieces;
 	}
 
 	//to state.
 	State StateData::to_state() const
 	{
-		HiddenPiece hidden;
-		for (auto p : _hidden_pieces)
-		{
-			hidden.push(p);
-		}
 		std::vector<std::vector<PieceType>> data(8, { PIECE_EMPTY,PIECE_EMPTY,PIECE_EMPTY,PIECE_EMPTY });
 		for (size_t y = 0; y < g_CDC_BOARD_HEIGHT; y++)
 		{
@@ -174,7 +164,7 @@ namespace chinese_dark_chess
 			}
 		}
 
-		return State(data, hidden, _next_player);
+		return State(data, _hidden_pieces, _next_player);
 	}
 
 	//to next state.
@@ -185,13 +175,71 @@ namespace chinese_dark_chess
 			_remove_hidden_flag = true;
 		}
 
+		//the accumulator is updated only if it is computed by the active network.
+		const bool update_accumulator = _accumulator.generation != 0 && _accumulator.generation == nnue::ActiveGeneration();
+
 		if (action.type == REMOVE_HIDDEN_ACTION)
 		{
 			reset_remove_hidden_flag();
 			_hidden_pieces.decrease(action.piece);
+			if (update_accumulator)
+			{
+				nnue::RemoveFeature(_accumulator, nnue::g_NNUE_HIDDEN_FEATURE + action.piece);
+			}
 			return;
 		}
 
+		if (update_accumulator)
+		{
+			const PieceType source_piece = piece_at(action.source);
+			if (source_piece != PIECE_EMPTY)
+			{
+				nnue::RemoveFeature(_accumulator, nnue::PieceFeature(source_piece, action.source));
+			}
+			if (action.dest != action.source)
+			{
+				const PieceType dest_piece = piece_at(action.dest);
+				if (dest_piece != PIECE_EMPTY)
+				{
+					nnue::RemoveFeature(_accumulator, nnue::PieceFeature(dest_piece, action.dest));
+				}
+			}
+			if (action.piece != PIECE_EMPTY)
+			{
+				nnue::AddFeature(_accumulator, nnue::PieceFeature(action.piece, action.dest));
+			}
+			if (action.type == FLIPPED_RESULT_ACTION)
+			{
+				nnue::RemoveFeature(_accumulator, nnue::g_NNUE_HIDDEN_FEATURE + action.piece);
+			}
+			else if (_next_player == PLAYER_RED)
+			{
+				nnue::AddFeature(_accumulator, nnue::g_NNUE_BLACK_PLAYER_FEATURE);
+			}
+			else
+			{
+				nnue::RemoveFeature(_accumulator, nnue::g_NNUE_BLACK_PLAYER_FEATURE);
+			}
+		}
+
+		//update the number of alive pieces.
+		if (action.type == CAPTURE_ACTION)
+		{
+			const PieceType victim = piece_at(action.dest);
+			if (victim >= PIECE_RED_PAWN && victim <= PIECE_BLACK_KING)
+			{
+				_alive_pieces.decrease(victim);
+			}
+			if (action.piece == PIECE_EMPTY)
+			{
+				_alive_pieces.decrease(piece_at(action.source));
+			}
+		}
+		else if (action.type == FLIPPED_RESULT_ACTION)
+		{
+			_alive_pieces.increase(action.piece);
+		}
+
 		BitBoard clear(0xFFFFFFFFFFFFFFFFULL);
 		clear.reset(action.source);
 		clear.reset(action.dest);
@@ -202,6 +250,16 @@ namespace chinese_dark_chess
 		_pieces[PIECE_EMPTY].reset(action.dest);
 		_pieces[action.piece].set(action.dest);
 
+		//count moves since last capture or flipping.
+		if (action.type == MOVE_ACTION)
+		{
+			_no_capture_count++;
+		}
+		else
+		{
+			_no_capture_count = 0;
+		}
+
 		if (action.type == FLIPPED_RESULT_ACTION)
 		{
 			_hidden_pieces.decrease(action.piece);
@@ -215,6 +273,53 @@ namespace chinese_dark_chess
 #endif
 	}
 
+	//compute accumulator.
+	void State::refresh_accumulator()
+	{
+		_accumulator.generation = nnue::ActiveGeneration();
+		if (_accumulator.generation == 0)
+		{
+			return;
+		}
+		nnue::ResetAccumulator(_accumulator);
+		for (uint8_t piece = PIECE_UNKNOWN; piece < PIECE_EMPTY; piece++)
+		{
+			uint64_t board = _pieces[piece].to_ullong();
+			while (board != 0)
+			{
+				nnue::AddFeature(_accumulator, nnue::PieceFeature(piece, gadt::stl::TrailingZeroCount(board)));
+				board &= board - 1;
+			}
+		}
+		for (uint8_t piece = PIECE_UNKNOWN; piece < PIECE_EMPTY; piece++)
+		{
+			for (size_t i = 0; i < _hidden_pieces[piece]; i++)
+			{
+				nnue::AddFeature(_accumulator, nnue::g_NNUE_HIDDEN_FEATURE + piece);
+			}
+		}
+		if (_next_player == PLAYER_BLACK)
+		{
+			nnue::AddFeature(_accumulator, nnue::g_NNUE_BLACK_PLAYER_FEATURE);
+		}
+	}
+
+	//get hash.
+	uint64_t State::hash() const
+	{
+		uint64_t hash = gadt::stl::MixHash(_hidden_pieces.to_ullong() ^ (uint64_t(_remove_hidden_flag) << 63));
+		if (_next_player == PLAYER_BLACK)
+		{
+			hash = ~hash;
+		}
+		for (uint8_t piece = PIECE_UNKNOWN; piece < PIECE_EMPTY; piece++)
+		{
+			//each board is salted by its piece id so that equal boards of different pieces are not canceled.
+			hash ^= gadt::stl::MixHash(_pieces[piece].to_ullong() + (uint64_t(piece) + 1) * 0x9E3779B97F4A7C15ULL);
+		}
+		return hash;
+	}
+
 	//get result.
 	Result State::get_result() const
 	{
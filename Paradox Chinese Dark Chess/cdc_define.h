@@ -19,6 +19,7 @@ namespace chinese_dark_chess
 	constexpr const size_t g_CDC_BOARD_WIDTH = 8;
 	constexpr const size_t g_CDC_BOARD_HEIGHT = 4;
 	constexpr const size_t g_CDC_MAX_LENGTH = g_CDC_BOARD_WIDTH * g_CDC_BOARD_HEIGHT;
+	constexpr const uint64_t g_CDC_BEGINING_HIDDEN = 1306644573751223552;	//hidden pieces in the begining, which is also the max count of each piece type.
 
 	//bitboard of the pieces.
 	using BitBoard = gadt::bitboard::BitBoard64;
@@ -27,6 +28,39 @@ namespace chinese_dark_chess
 	extern size_t g_MOVEABLE_INDEX[g_CDC_MAX_LENGTH][4];
 	extern BitBoard g_MOVEABLE_BITBOARD[g_CDC_MAX_LENGTH];
 
+	//get the locations that a cannon at the location could capture, which are the second pieces along its row and column.
+	//a cannon never jumps across the edge of the board. it is shared by action generator and eval so that they agree.
+	inline uint64_t CannonFlyBoard(size_t loc, uint64_t exist_piece_board)
+	{
+		constexpr int dir_x[4] = { 1,-1,0,0 };
+		constexpr int dir_y[4] = { 0,0,1,-1 };
+		uint64_t fly_board = 0;
+		for (size_t n = 0; n < 4; n++)
+		{
+			int x = int(loc % g_CDC_BOARD_WIDTH);
+			int y = int(loc / g_CDC_BOARD_WIDTH);
+			bool found_first = false;
+			for (;;)
+			{
+				x += dir_x[n];
+				y += dir_y[n];
+				if (x < 0 || x >= int(g_CDC_BOARD_WIDTH) || y < 0 || y >= int(g_CDC_BOARD_HEIGHT))
+					break;
+				const size_t target = size_t(y) * g_CDC_BOARD_WIDTH + size_t(x);
+				if ((exist_piece_board >> target) & 1)
+				{
+					if (found_first)
+					{
+						fly_board |= uint64_t(1) << target;
+						break;
+					}
+					found_first = true;
+				}
+			}
+		}
+		return fly_board;
+	}
+
 	//index of players.
 	enum PlayerIndex : int8_t
 	{
@@ -85,6 +119,41 @@ namespace chinese_dark_chess
 	//basic data struct of game state.
 	class State;
 
+	//the first layer of NNUE, which is kept in each state and updated incrementally by State::to_next.
+	//the functions are defined in cdc_nnue.cpp.
+	namespace nnue
+	{
+		constexpr const size_t g_NNUE_PIECE_FEATURE_COUNT = g_CDC_MAX_LENGTH * 16;			//features of each piece id in each location.
+		constexpr const size_t g_NNUE_HIDDEN_FEATURE = g_NNUE_PIECE_FEATURE_COUNT;			//first feature of hidden piece counts, indexed by piece id.
+		constexpr const size_t g_NNUE_BLACK_PLAYER_FEATURE = g_NNUE_HIDDEN_FEATURE + 16;	//feature that is active if black player is next.
+		constexpr const size_t g_NNUE_FEATURE_COUNT = g_NNUE_BLACK_PLAYER_FEATURE + 1;
+		constexpr const size_t g_NNUE_ACCUMULATOR_SIZE = 32;
+
+		struct Accumulator
+		{
+			int16_t		values[g_NNUE_ACCUMULATOR_SIZE];
+			uint32_t	generation;		//generation of the network that computed the values, 0 if the values are invalid.
+		};
+
+		//get the feature of a piece in a location.
+		inline size_t PieceFeature(size_t piece, size_t location)
+		{
+			return piece * g_CDC_MAX_LENGTH + location;
+		}
+
+		//get the generation of the active network, which is 0 if no network is loaded.
+		uint32_t ActiveGeneration();
+
+		//set the accumulator to the bias of the active network.
+		void ResetAccumulator(Accumulator& accumulator);
+
+		//add a feature to the accumulator by the active network.
+		void AddFeature(Accumulator& accumulator, size_t feature);
+
+		//remove a feature from the accumulator by the active network.
+		void RemoveFeature(Accumulator& accumulator, size_t feature);
+	}
+
 	//location.
 	struct Location
 	{
@@ -150,7 +219,7 @@ namespace chinese_dark_chess
 	{
 	private:
 		PieceType _data[g_CDC_BOARD_WIDTH][g_CDC_BOARD_HEIGHT];
-		std::vector<PieceType> _hidden_pieces;
+		HiddenPiece _hidden_pieces;		//kept as counts so that the data, and the state that contains it, are trivially destructible.
 		PlayerIndex _next_player;
 
 	public:
@@ -179,10 +248,8 @@ namespace chinese_dark_chess
 		//translate to state.
 		State to_state() const;
 
-		const std::vector<PieceType>& hidden_pieces() const
-		{
-			return _hidden_pieces;
-		}
+		//get hidden pieces in the order of piece id.
+		std::vector<PieceType> hidden_pieces() const;
 
 		PlayerIndex next_player() const
 		{
@@ -223,7 +290,7 @@ namespace chinese_dark_chess
 		{
 			if (_all_weight_equal)
 			{
-				size_t rnd = rand() % size();
+				size_t rnd = gadt::random::RandomIndex(size());
 				return _action_pool.get_element(rnd);
 			}
 			
@@ -243,9 +310,11 @@ namespace chinese_dark_chess
 	private:
 		BitBoard	_pieces[g_CDC_BITBOARD_SIZE];	//pieces.
 		HiddenPiece	_hidden_pieces;					//pieces that still no be flipped.
+		HiddenPiece	_alive_pieces;					//the number of flipped pieces of each type on the board, updated in to_next.
 		PlayerIndex _next_player;					//index of last moved player.
-		size_t		_no_capture_count;				//the count of no capture, draw if the value more than 20.
+		size_t		_no_capture_count;				//the count of moves without capture or flipping, draw if the value more than 20.
 		bool		_remove_hidden_flag;			//if true, in the next one hidden piece must be removed.
+		nnue::Accumulator _accumulator;				//accumulator of NNUE, updated in to_next if it is computed by the active network.
 
 #ifdef CDC_DEBUG_INFO
 		StateData	_debug_data;					//debug data
@@ -254,18 +323,23 @@ namespace chinese_dark_chess
 	public:
 		template <typename T>const BitBoard& piece_board(T id) const { return _pieces[id]; }
 		const HiddenPiece& hidden_pieces() const { return _hidden_pieces; }
+		const HiddenPiece& alive_pieces() const { return _alive_pieces; }
 		PlayerIndex next_player() const { return _next_player; }
 		size_t no_capture_count() const { return _no_capture_count; }
+		const nnue::Accumulator& accumulator() const { return _accumulator; }
 
 	public:
 
 		//default constructor, generate a new state.
 		State():
-			_hidden_pieces(1306644573751223552),
+			_hidden_pieces(g_CDC_BEGINING_HIDDEN),
+			_alive_pieces(0),
 			_next_player(PLAYER_RED),
-			_no_capture_count(0)
+			_no_capture_count(0),
+			_remove_hidden_flag(false)
 		{
 			_pieces[PIECE_UNKNOWN] = BitBoard(4294967295);
+			refresh_accumulator();
 #ifdef CDC_DEBUG_INFO
 			_debug_data.update(*this);
 #endif
@@ -273,15 +347,45 @@ namespace chinese_dark_chess
 
 		State(const std::vector<std::vector<PieceType>>& data, HiddenPiece hidden, PlayerIndex next_player):
 			_hidden_pieces(hidden),
-			_next_player(next_player)
+			_alive_pieces(0),
+			_next_player(next_player),
+			_no_capture_count(0),
+			_remove_hidden_flag(false)
 		{
 			for (size_t y = 0; y < g_CDC_BOARD_HEIGHT; y++)
 			{
 				for (size_t x = 0; x < g_CDC_BOARD_WIDTH; x++)
 				{
 					_pieces[data[x][y]].set((y* g_CDC_BOARD_WIDTH) + x);
+					if (data[x][y] >= PIECE_RED_PAWN && data[x][y] <= PIECE_BLACK_KING)
+					{
+						_alive_pieces.increase(data[x][y]);
+					}
 				}
 			}
+			refresh_accumulator();
+#ifdef CDC_DEBUG_INFO
+			_debug_data.update(*this);
+#endif
+		}
+
+		//construct by the pieces of each location, which is (y * g_CDC_BOARD_WIDTH) + x.
+		State(const PieceType(&board)[g_CDC_MAX_LENGTH], HiddenPiece hidden, PlayerIndex next_player) :
+			_hidden_pieces(hidden),
+			_alive_pieces(0),
+			_next_player(next_player),
+			_no_capture_count(0),
+			_remove_hidden_flag(false)
+		{
+			for (size_t i = 0; i < g_CDC_MAX_LENGTH; i++)
+			{
+				_pieces[board[i]].set(i);
+				if (board[i] >= PIECE_RED_PAWN && board[i] <= PIECE_BLACK_KING)
+				{
+					_alive_pieces.increase(board[i]);
+				}
+			}
+			refresh_accumulator();
 #ifdef CDC_DEBUG_INFO
 			_debug_data.update(*this);
 #endif
@@ -307,6 +411,25 @@ namespace chinese_dark_chess
 		//get result of the state.
 		Result get_result() const;
 
+		//compute the accumulator of NNUE from all features by the active network.
+		void refresh_accumulator();
+
+		//get the hash of the state, which is made of pieces, hidden pieces, next player and remove hidden flag.
+		uint64_t hash() const;
+
+		//get the piece in the location index.
+		inline PieceType piece_at(size_t index) const
+		{
+			for (uint8_t piece = PIECE_UNKNOWN; piece < PIECE_EMPTY; piece++)
+			{
+				if (_pieces[piece].get(index))
+				{
+					return PieceType(piece);
+				}
+			}
+			return PIECE_EMPTY;
+		}
+
 		//get all exist piece board
 		inline BitBoard get_exist_piece_board() const
 		{
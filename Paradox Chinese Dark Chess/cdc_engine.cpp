@@ -0,0 +1,263 @@
+#include "cdc_engine.h"
+
+namespace chinese_dark_chess
+{
+	namespace engine_func
+	{
+		constexpr const double g_WIN_EVAL = 1000;
+
+		void MakeAction(const State & state, ActionList & actions, ActionGeneratorPolicy policy)
+		{
+			ActionGenerator generator(state, policy);
+			for (size_t i = 0; i < generator.size(); i++)
+			{
+				actions.push_back(generator[i]);
+			}
+		}
+
+		bool IsChanceState(const State & state)
+		{
+			return state.exist_undecided_piece() || state.remove_hidden_flag();
+		}
+
+		size_t ChanceWeight(const State & state, const Action & outcome)
+		{
+			return state.hidden_pieces()[outcome.piece];
+		}
+
+		void ResolveChance(State & state)
+		{
+			while (IsChanceState(state))
+			{
+				ActionGenerator generator(state);
+				state.to_next(generator.random_action());
+			}
+		}
+
+		State GetNewState(const State & state, const Action & action)
+		{
+			State new_state = state;
+			new_state.to_next(action);
+			ResolveChance(new_state);
+			return new_state;
+		}
+
+		int8_t DetemineWinner(const State & state)
+		{
+			switch (state.get_result())
+			{
+			case RESULT_RED_WIN:
+				return PLAYER_RED;
+			case RESUKT_BLACK_WIN:
+				return PLAYER_BLACK;
+			case RESULT_DRAW:
+				return 2;
+			default:
+				break;
+			}
+			//the player who has no action to do loses the game.
+			if (!ExistAction(state))
+			{
+				return int8_t(-state.next_player());
+			}
+			return 0;
+		}
+
+		double EvalForParent(const State & state, int8_t winner)
+		{
+			const PlayerIndex parent = PlayerIndex(-state.next_player());
+			if (winner == 2)
+			{
+				return 0;
+			}
+			if (winner != 0)
+			{
+				return winner == parent ? g_WIN_EVAL : -g_WIN_EVAL;
+			}
+			return StateEval(state).eval(parent);
+		}
+
+		double NnueEvalForParent(const State & state, int8_t winner)
+		{
+			const PlayerIndex parent = PlayerIndex(-state.next_player());
+			if (winner == 2)
+			{
+				return 0;
+			}
+			if (winner != 0)
+			{
+				return winner == parent ? g_WIN_EVAL : -g_WIN_EVAL;
+			}
+			return nnue::Evaluate(state, parent);
+		}
+
+		int8_t NnueSimulation(const State & state)
+		{
+			const double probability = nnue::WinProbability(state, PLAYER_RED);
+			return (gadt::random::ThreadRand() >> 11) * (1.0 / 9007199254740992.0) < probability ? PLAYER_RED : PLAYER_BLACK;
+		}
+	}
+
+	Engine::Engine(EngineSetting setting) :
+		_setting(setting),
+		_ordering(),
+		_last_process_type(STATE_BEGINING),
+		_mcts_allocator(),
+		_minimax()
+	{
+	}
+
+	EngineMcts::Allocator & Engine::mcts_allocator()
+	{
+		if (!_mcts_allocator)
+		{
+			_mcts_allocator.reset(new EngineMcts::Allocator(_setting.battle_max_node));
+		}
+		return *_mcts_allocator;
+	}
+
+	EngineMinimax & Engine::minimax()
+	{
+		if (_minimax)
+		{
+			return *_minimax;
+		}
+		_minimax.reset(new EngineMinimax(
+			[](const State& state, const Action& action)->State {
+				State new_state = state;
+				new_state.to_next(action);
+				return new_state;
+			},
+			[](const State& state, EngineMinimax::ActionSet& actions) { engine_func::MakeAction(state, actions); },
+			[](const State& state)->gadt::minimax::AgentIndex { return engine_func::DetemineWinner(state); },
+			[this](const State& state, gadt::minimax::AgentIndex winner)->gadt::minimax::EvalValue {
+				return _setting.use_nnue && nnue::Enabled() ? engine_func::NnueEvalForParent(state, winner) : engine_func::EvalForParent(state, winner);
+			}
+		));
+		_minimax->InitOrdering(
+			[this](const State& state, const Action& action, size_t ply) { return _ordering.priority(state, action, ply); },
+			[this](const State& state, const Action& action, size_t ply, size_t depth) { _ordering.record_cutoff(state, action, ply, depth); }
+		);
+		_minimax->InitQuiescence([](const State& state, EngineMinimax::ActionSet& actions) { engine_func::MakeAction(state, actions, CAPTURE_ONLY_POLICY); });
+		//the count of moves without capture decides the draw, so positions of different counts must not share entries.
+		_minimax->InitTranspositionTable([](const State& state) {
+			return state.hash() ^ gadt::stl::MixHash(state.no_capture_count() + 1);
+		}, _setting.dead_tt_mb);
+		return *_minimax;
+	}
+
+	Action Engine::DoSearch(const State & state)
+	{
+		//to_next only updates accumulators computed by the active network, so a root created before the network
+		//is loaded is refreshed once, then all states in the search are updated incrementally.
+		if (_setting.use_nnue && nnue::Enabled() && state.accumulator().generation != nnue::ActiveGeneration())
+		{
+			State root = state;
+			root.refresh_accumulator();
+			return DoSearch(root);
+		}
+
+		//actions of chance are decided by random.
+		if (engine_func::IsChanceState(state))
+		{
+			ActionGenerator generator(state);
+			return generator.random_action();
+		}
+
+		_last_process_type = StateEval(state).process_type();
+		switch (_last_process_type)
+		{
+		case STATE_BEGINING:
+			return DoFlipHeuristic(state);
+		case STATE_DEAD:
+			return DoAlphaBeta(state);
+		default:
+			return DoMcts(state);
+		}
+	}
+
+	Action Engine::DoFlipHeuristic(const State & state)
+	{
+		const PlayerIndex player = state.next_player();
+		ActionGenerator generator(state);
+		gadt::timer::Deadline deadline(_setting.begining_timeout);
+		double best_value = -std::numeric_limits<double>::infinity();
+		size_t best_index = 0;
+		size_t best_count = 0;
+		for (size_t i = 0; i < generator.size(); i++)
+		{
+			if (i > 0 && deadline.poll_timeout())
+			{
+				break;
+			}
+
+			const Action& action = generator[i];
+			State next = state;
+			next.to_next(action);
+			double value = 0;
+			if (engine_func::IsChanceState(next))
+			{
+				//average eval of all chance outcomes.
+				ActionGenerator outcomes(next);
+				size_t total_weight = 0;
+				for (size_t n = 0; n < outcomes.size(); n++)
+				{
+					const size_t weight = next.hidden_pieces()[outcomes[n].piece];
+					State outcome = next;
+					outcome.to_next(outcomes[n]);
+					value += weight * StateEval(outcome).eval(player);
+					total_weight += weight;
+				}
+				value = total_weight > 0 ? value / total_weight : 0;
+			}
+			else
+			{
+				value = StateEval(next).eval(player);
+			}
+
+			//break ties by random.
+			if (value > best_value)
+			{
+				best_value = value;
+				best_index = i;
+				best_count = 1;
+			}
+			else if (value == best_value && gadt::random::RandomIndex(++best_count) == 0)
+			{
+				best_index = i;
+			}
+		}
+		return generator[best_index];
+	}
+
+	Action Engine::DoMcts(const State & state)
+	{
+		//chance is not resolved by the transition, so each flip is a chance node and all its outcomes are searched.
+		EngineMcts mcts(
+			[](const State& state, const Action& action)->State {
+				State new_state = state;
+				new_state.to_next(action);
+				return new_state;
+			},
+			[](const State& state, EngineMcts::ActionSet& actions) { engine_func::MakeAction(state, actions); },
+			[](const State& state)->gadt::mcts_new::AgentIndex { return engine_func::DetemineWinner(state); },
+			[](const State&, gadt::mcts_new::AgentIndex winner)->int8_t { return winner; },
+			[](const State& state, const int8_t& winner)->bool { return winner == -state.next_player(); },
+			mcts_allocator()
+		);
+		mcts.InitChance(engine_func::IsChanceState, engine_func::ChanceWeight);
+		if (_setting.use_nnue && nnue::Enabled())
+		{
+			mcts.InitSimulation(engine_func::NnueSimulation);
+		}
+		return mcts.DoMcts(state, gadt::mcts_new::MctsSetting(_setting.battle_timeout, _setting.battle_max_iteration, false));
+	}
+
+	Action Engine::DoAlphaBeta(const State & state)
+	{
+		_ordering.new_search();
+		gadt::minimax::MinimaxSetting setting(_setting.dead_timeout, _setting.dead_max_depth, true);
+		setting.thread_count = _setting.dead_thread_count;
+		return minimax().DoAlphaBeta(state, setting);
+	}
+}
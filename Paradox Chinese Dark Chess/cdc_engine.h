@@ -0,0 +1,123 @@
+#include "cdc_policy.hpp"
+#include "cdc_eval.h"
+#include "cdc_ordering.h"
+#include "cdc_nnue.h"
+
+#pragma once
+
+namespace chinese_dark_chess
+{
+	//functions that connect the game to search templates.
+	namespace engine_func
+	{
+		using ActionList = std::vector<Action>;
+
+		//get all actions of the state by policy.
+		void MakeAction(const State& state, ActionList& actions, ActionGeneratorPolicy policy = DEFAULT_POLICY);
+
+		//return true if the next action of the state is chance, which is flipped result or removed hidden piece.
+		bool IsChanceState(const State& state);
+
+		//get the weight of an outcome of chance, which is the count of the hidden piece.
+		size_t ChanceWeight(const State& state, const Action& outcome);
+
+		//resolve chance of the state by random, which is flipped result or removed hidden piece.
+		void ResolveChance(State& state);
+
+		//get the next state by action, the chance caused by the action is resolved by random.
+		State GetNewState(const State& state, const Action& action);
+
+		//get the winner of the state, 0 is no winner and 2 is draw.
+		int8_t DetemineWinner(const State& state);
+
+		//get the eval of the state for the player who moved into it.
+		double EvalForParent(const State& state, int8_t winner);
+
+		//get the eval of the state for the player who moved into it by NNUE, the network must be loaded.
+		double NnueEvalForParent(const State& state, int8_t winner);
+
+		//get the winner of a simulation by NNUE, which is sampled by the win probability of red player.
+		int8_t NnueSimulation(const State& state);
+	}
+
+	//MCTS used by engine.
+	using EngineMcts = gadt::mcts_new::MonteCarloTreeSearch<State, Action, int8_t>;
+
+	//alpha-beta used by engine.
+	using EngineMinimax = gadt::minimax::MinimaxSearch<State, Action>;
+
+	//budget of each phase.
+	struct EngineSetting
+	{
+		double	begining_timeout;		//timeout of begining, which is only used by flip heuristic.
+		double	battle_timeout;			//timeout of MCTS in battle.
+		size_t	battle_max_iteration;	//max iteration of MCTS in battle.
+		size_t	battle_max_node;		//max node count of MCTS in battle.
+		double	dead_timeout;			//timeout of alpha-beta in dead state.
+		size_t	dead_max_depth;			//max depth of alpha-beta in dead state.
+		size_t	dead_tt_mb;				//memory of the transposition table of alpha-beta in MB, which is kept between searches.
+		size_t	dead_thread_count;		//threads of alpha-beta, Lazy SMP is used if it is more than 1.
+		bool	use_nnue;				//replace playouts of MCTS and evals of alpha-beta by NNUE if a network is loaded.
+
+		EngineSetting() :
+			begining_timeout(1),
+			battle_timeout(5),
+			battle_max_iteration(100000),
+			battle_max_node(200000),
+			dead_timeout(5),
+			dead_max_depth(24),
+			dead_tt_mb(16),
+			dead_thread_count(1),
+			use_nnue(true)
+		{
+		}
+	};
+
+	/*
+	* Engine selects an action by the phase of the state.
+	*
+	* begining: the action with the best expected eval after one ply, which mainly selects flips.
+	* battle: MCTS, the outcomes of flips are chance nodes inside the tree, which are sampled by the count of hidden pieces in each iteration.
+	* if NNUE is used, MCTS samples simulation results by the network instead of playouts and alpha-beta evals leaves by it.
+	* dead: alpha-beta with quiescence search, move ordering and transposition table, the state is deterministic since all pieces are flipped.
+	* alpha-beta uses one thread by default since the server already runs one engine per worker.
+	*/
+	class Engine
+	{
+	private:
+		EngineSetting		_setting;
+		MoveOrdering		_ordering;
+		StateProcessType	_last_process_type;
+		std::unique_ptr<EngineMcts::Allocator> _mcts_allocator;	//node pool of MCTS, which is created by the first MCTS and kept between searches.
+		std::unique_ptr<EngineMinimax> _minimax;				//alpha-beta search, which is created by the first alpha-beta and kept between searches.
+
+	private:
+		//get the node pool of MCTS, which is created if it does not exist.
+		EngineMcts::Allocator& mcts_allocator();
+
+		//get the alpha-beta search with its transposition table, which is created if it does not exist.
+		EngineMinimax& minimax();
+
+	public:
+		//the engine must not be shared by threads, each thread should have its own engine.
+		Engine(EngineSetting setting = EngineSetting());
+
+		//select an action for the state.
+		Action DoSearch(const State& state);
+
+		//select an action by the expected eval after one ply.
+		Action DoFlipHeuristic(const State& state);
+
+		//select an action by MCTS.
+		Action DoMcts(const State& state);
+
+		//select an action by alpha-beta.
+		Action DoAlphaBeta(const State& state);
+
+		//get the phase of last search.
+		StateProcessType last_process_type() const
+		{
+			return _last_process_type;
+		}
+	};
+}
@@ -2,5 +2,265 @@
 
 namespace chinese_dark_chess
 {
+	//return true if the piece rank can capture the other one by moving, cannon can only capture by jumping.
+	inline bool CanCaptureByMove(size_t attacker_rank, size_t victim_rank)
+	{
+		if (attacker_rank == 1)
+			return false;
+		if (attacker_rank == 0)
+			return victim_rank == 0 || victim_rank == 6;
+		if (attacker_rank == 6)
+			return victim_rank != 0;
+		return attacker_rank >= victim_rank;
+	}
 
+	//max count of each piece rank of a player.
+	constexpr size_t g_MAX_PIECE_COUNT[7] = { 5, 2, 2, 2, 2, 2, 1 };
+
+	MaterialTable::MaterialTable(const EvalWeight & weight)
+	{
+		for (size_t signature = 0; signature < g_CDC_MATERIAL_SIGNATURE_COUNT; signature++)
+		{
+			//decode the count of each enemy piece rank, king is the lowest digit.
+			size_t count[7];
+			size_t code = signature;
+			for (size_t rank = 7; rank-- > 0;)
+			{
+				count[rank] = code % (g_MAX_PIECE_COUNT[rank] + 1);
+				code /= g_MAX_PIECE_COUNT[rank] + 1;
+			}
+			double total_value = 0;
+			for (size_t rank = 0; rank < 7; rank++)
+			{
+				total_value += weight.piece_value[rank] * count[rank];
+			}
+
+			for (size_t rank = 0; rank < 7; rank++)
+			{
+				double prey_value = 0;
+				size_t predator_count = count[1];//cannons can capture any piece.
+				for (size_t enemy_rank = 0; enemy_rank < 7; enemy_rank++)
+				{
+					if (rank == 1 || CanCaptureByMove(rank, enemy_rank))
+					{
+						prey_value += weight.piece_value[enemy_rank] * count[enemy_rank];
+					}
+					if (CanCaptureByMove(enemy_rank, rank))
+					{
+						predator_count += count[enemy_rank];
+					}
+				}
+				const double prey_share = total_value > 0 ? prey_value / total_value : 0;
+				const double safety = 1 / double(1 + predator_count);
+				_values[signature][rank] = float(weight.piece_value[rank] * (1 + weight.prey_scale * prey_share) * (1 + weight.safety_scale * safety));
+			}
+		}
+	}
+
+	size_t MaterialTable::Signature(const State & state, PlayerIndex player)
+	{
+		const size_t pawn_id = player == PLAYER_RED ? PIECE_RED_PAWN : PIECE_BLACK_PAWN;
+		size_t signature = 0;
+		for (size_t rank = 0; rank < 7; rank++)
+		{
+			const size_t count = state.alive_pieces()[pawn_id + rank] + state.hidden_pieces()[pawn_id + rank];
+			signature = signature * (g_MAX_PIECE_COUNT[rank] + 1) + std::min(count, g_MAX_PIECE_COUNT[rank]);
+		}
+		return signature;
+	}
+
+	const EvalWeight & StateEval::default_weight()
+	{
+		static const EvalWeight weight;
+		return weight;
+	}
+
+	const MaterialTable & StateEval::default_table()
+	{
+		static const MaterialTable table(default_weight());
+		return table;
+	}
+
+	EvalCache & StateEval::default_cache()
+	{
+		static EvalCache cache(g_CDC_EVAL_CACHE_MB);
+		return cache;
+	}
+
+	uint64_t StateEval::CannonAttackBoard(PlayerIndex player) const
+	{
+		uint64_t attack_board = 0;
+		uint64_t cannon_board = _state.piece_board(PawnId(player) + 1).to_ullong();
+		const uint64_t exist_piece_board = _state.get_exist_piece_board().to_ullong();
+		while (cannon_board != 0)
+		{
+			const size_t i = gadt::stl::TrailingZeroCount(cannon_board);
+			cannon_board &= cannon_board - 1;
+			attack_board |= CannonFlyBoard(i, exist_piece_board);
+		}
+		return attack_board;
+	}
+
+	double StateEval::alive_value(PlayerIndex player) const
+	{
+		const uint8_t pawn_id = PawnId(player);
+		const float* values = piece_values(player);
+		double value = 0;
+		for (size_t rank = 0; rank < 7; rank++)
+		{
+			value += values[rank] * _state.alive_pieces()[pawn_id + rank];
+		}
+		return value;
+	}
+
+	double StateEval::hidden_value(PlayerIndex player) const
+	{
+		const uint8_t pawn_id = PawnId(player);
+		const float* values = piece_values(player);
+		double value = 0;
+		for (size_t rank = 0; rank < 7; rank++)
+		{
+			value += values[rank] * _state.hidden_pieces()[pawn_id + rank];
+		}
+		return value * _weight.hidden_scale;
+	}
+
+	size_t StateEval::mobility(PlayerIndex player) const
+	{
+		const uint8_t self_pawn_id = PawnId(player);
+		const uint8_t enemy_pawn_id = PawnId(PlayerIndex(-player));
+		size_t count = 0;
+		for (size_t rank = 0; rank < 7; rank++)
+		{
+			uint64_t piece_board = _state.piece_board(self_pawn_id + rank).to_ullong();
+			if (piece_board == 0)
+				continue;
+
+			//locations that the piece can move to.
+			uint64_t target_board = _state.get_empty_piece_board().to_ullong();
+			for (size_t victim_rank = 0; victim_rank < 7; victim_rank++)
+			{
+				if (CanCaptureByMove(rank, victim_rank))
+				{
+					target_board |= _state.piece_board(enemy_pawn_id + victim_rank).to_ullong();
+				}
+			}
+			while (piece_board != 0)
+			{
+				const size_t i = gadt::stl::TrailingZeroCount(piece_board);
+				piece_board &= piece_board - 1;
+				count += gadt::stl::PopCount(g_MOVEABLE_BITBOARD[i].to_ullong() & target_board);
+			}
+		}
+		return count;
+	}
+
+	double StateEval::threatened_value(PlayerIndex player) const
+	{
+		const uint8_t self_pawn_id = PawnId(player);
+		const uint8_t enemy_pawn_id = PawnId(PlayerIndex(-player));
+
+		//locations that can be reached by each enemy piece rank.
+		uint64_t reach_board[7];
+		for (size_t rank = 0; rank < 7; rank++)
+		{
+			reach_board[rank] = 0;
+			uint64_t piece_board = _state.piece_board(enemy_pawn_id + rank).to_ullong();
+			while (piece_board != 0)
+			{
+				const size_t i = gadt::stl::TrailingZeroCount(piece_board);
+				piece_board &= piece_board - 1;
+				reach_board[rank] |= g_MOVEABLE_BITBOARD[i].to_ullong();
+			}
+		}
+		const uint64_t cannon_attack_board = CannonAttackBoard(PlayerIndex(-player));
+
+		const float* values = piece_values(player);
+		double value = 0;
+		for (size_t rank = 0; rank < 7; rank++)
+		{
+			uint64_t attack_board = cannon_attack_board;
+			for (size_t attacker_rank = 0; attacker_rank < 7; attacker_rank++)
+			{
+				if (CanCaptureByMove(attacker_rank, rank))
+				{
+					attack_board |= reach_board[attacker_rank];
+				}
+			}
+			attack_board &= _state.piece_board(self_pawn_id + rank).to_ullong();
+			value += values[rank] * gadt::stl::PopCount(attack_board);
+		}
+		return value * _weight.threat;
+	}
+
+	double StateEval::eval_uncached(PlayerIndex player) const
+	{
+		const PlayerIndex opponent = PlayerIndex(-player);
+		const double material =
+			alive_value(player) + hidden_value(player) -
+			alive_value(opponent) - hidden_value(opponent);
+		const double mobility_value = _weight.mobility * (double(mobility(player)) - double(mobility(opponent)));
+
+		//threatened pieces of the player to move are not lost yet.
+		double threat_value = 0;
+		if (_state.next_player() == player)
+		{
+			threat_value = threatened_value(opponent);
+		}
+		else
+		{
+			threat_value = -threatened_value(player);
+		}
+		return material + mobility_value + threat_value;
+	}
+
+	double StateEval::eval(PlayerIndex player) const
+	{
+		if (_cache == nullptr || !_cache->enabled())
+		{
+			return eval_uncached(player);
+		}
+
+		//eval is zero-sum, so only the eval of red player is saved.
+		const uint64_t key = _state.hash();
+		double red_eval = 0;
+		if (!_cache->probe(key, red_eval))
+		{
+			red_eval = eval_uncached(PLAYER_RED);
+			_cache->store(key, red_eval);
+		}
+		return player == PLAYER_RED ? red_eval : -red_eval;
+	}
+
+	double StateEval::win_probability(PlayerIndex player) const
+	{
+		return 1 / (1 + std::exp(-eval(player) / _weight.logistic_scale));
+	}
+
+	StateProcessType StateEval::process_type() const
+	{
+		const size_t hidden_count = gadt::stl::PopCount(_state.piece_board(PIECE_UNKNOWN).to_ullong());
+		if (hidden_count >= g_CDC_BEGINING_HIDDEN_COUNT)
+		{
+			size_t total_count = 0;
+			for (size_t piece = PIECE_RED_PAWN; piece <= PIECE_BLACK_KING; piece++)
+			{
+				total_count += _state.alive_pieces()[piece] + _state.hidden_pieces()[piece];
+			}
+			return total_count == g_CDC_MAX_LENGTH ? STATE_BEGINING : STATE_BATTLE;
+		}
+		if (hidden_count == 0 && _state.hidden_pieces().none())
+		{
+			size_t alive_count = 0;
+			for (size_t piece = PIECE_RED_PAWN; piece <= PIECE_BLACK_KING; piece++)
+			{
+				alive_count += _state.alive_pieces()[piece];
+			}
+			if (alive_count <= g_CDC_DEAD_PIECE_COUNT || mobility(PLAYER_RED) + mobility(PLAYER_BLACK) <= g_CDC_DEAD_MOBILITY)
+			{
+				return STATE_DEAD;
+			}
+		}
+		return STATE_BATTLE;
+	}
 }
@@ -4,22 +4,156 @@
 
 namespace chinese_dark_chess
 {
+	//phase of the game.
 	enum StateProcessType : uint8_t
 	{
-		STATE_BEGINING = 0,
-		STATE_BATTLE = 1,
-		STATE_DEAD = 2
+		STATE_BEGINING = 0,		//most pieces are hidden and no exchange happened.
+		STATE_BATTLE = 1,		//pieces are fighting with hidden pieces on the board.
+		STATE_DEAD = 2			//all pieces are flipped and few pieces or moves are left.
 	};
 
+	constexpr const size_t g_CDC_BEGINING_HIDDEN_COUNT = 26;	//min number of hidden pieces on the board in begining.
+	constexpr const size_t g_CDC_DEAD_PIECE_COUNT = 10;			//the state is dead if all pieces are flipped and alive pieces are no more than it.
+	constexpr const size_t g_CDC_DEAD_MOBILITY = 16;			//the state is dead if all pieces are flipped and total mobility is no more than it.
+
+	//cache of evals from the view of red player, which is keyed by the hash of states.
+	using EvalCache = gadt::stl::ValueCache<double>;
+
+	constexpr const size_t g_CDC_EVAL_CACHE_MB = 8;	//memory size of default eval cache.
+
+	//the number of material signatures of a player, which is 6 * 3^5 * 2 by the max count of each piece rank.
+	constexpr const size_t g_CDC_MATERIAL_SIGNATURE_COUNT = 2916;
+
+	//weights of the static evaluation.
+	struct EvalWeight
+	{
+		double piece_value[7];	//base value of each piece rank, from pawn to king.
+		double prey_scale;		//scale of the share of enemy material that a piece can capture.
+		double safety_scale;	//scale of the safety of a piece, which is higher if less enemy pieces can capture it.
+		double hidden_scale;	//scale of the value of hidden pieces, which are not controllable.
+		double mobility;		//value of each available move.
+		double threat;			//scale of the value of threatened pieces.
+		double logistic_scale;	//scale of the logistic function that converts eval to win probability.
+
+		//default weights.
+		EvalWeight() :
+			piece_value{ 2, 6, 3, 5, 8, 12, 16 },
+			prey_scale(0.5),
+			safety_scale(0.5),
+			hidden_scale(0.8),
+			mobility(0.1),
+			threat(0.5),
+			logistic_scale(10)
+		{
+		}
+	};
+
+	/*
+	* MaterialTable saves the dynamic value of each piece rank for each material signature of the enemy.
+	*
+	* the signature of a player is made of the count of alive and hidden pieces of each rank. a piece is more valuable
+	* if it can capture more enemy material and less enemy pieces can capture it, for example a rook is nearly invulnerable
+	* once enemy kings and cannons are gone. the table is computed once by weights, so evaluating material is a table lookup.
+	*/
+	class MaterialTable
+	{
+	private:
+		float _values[g_CDC_MATERIAL_SIGNATURE_COUNT][7];
+
+	public:
+		//compute the table by weights.
+		MaterialTable(const EvalWeight& weight);
+
+		//get the material signature of the player.
+		static size_t Signature(const State& state, PlayerIndex player);
+
+		//get the values of piece ranks of a player whose enemy has the signature.
+		inline const float* values(size_t enemy_signature) const
+		{
+			return _values[enemy_signature];
+		}
+	};
+
+	/*
+	* StateEval is the static evaluator of a state.
+	*
+	* material is got from alive pieces and hidden pieces, which are updated incrementally by State::to_next,
+	* and the value of pieces is looked up in MaterialTable by the signature of the enemy.
+	* mobility and threats are recomputed from bitboards of the state on each eval, which are read as raw 64-bit words.
+	* they are not kept in State since to_next runs on every playout step and search node while only evaluated leaves
+	* need them, one move changes the neighbors of two locations and the lines of cannons, and repeated leaves hit the cache.
+	* all evals are from the view of the appointed player.
+	* evals are saved in an EvalCache by the hash of the state. evals of default weights use the default cache,
+	* and a cache for other weights could be appointed, which must not be shared by evaluators of different weights.
+	*/
 	class StateEval
 	{
 	private:
 		const State& _state;
+		const EvalWeight& _weight;
+		const float* _red_values;		//values of red piece ranks.
+		const float* _black_values;		//values of black piece ranks.
+		EvalCache* _cache;				//cache of evals, nullptr if disabled.
+
+	private:
+		//get the first piece id of the player.
+		static inline uint8_t PawnId(PlayerIndex player)
+		{
+			return player == PLAYER_RED ? PIECE_RED_PAWN : PIECE_BLACK_PAWN;
+		}
+
+		//get the board of locations that the cannons of the player can capture by jumping.
+		uint64_t CannonAttackBoard(PlayerIndex player) const;
+
+		//get the values of piece ranks of the player.
+		inline const float* piece_values(PlayerIndex player) const
+		{
+			return player == PLAYER_RED ? _red_values : _black_values;
+		}
 
 	public:
-		StateEval(const State& state):
-			_state(state)
+		//default weights.
+		static const EvalWeight& default_weight();
+
+		//material table of default weights.
+		static const MaterialTable& default_table();
+
+		//eval cache of default weights.
+		static EvalCache& default_cache();
+
+		//the table must be computed by the same weights, the default cache is used if no cache is appointed for default weights.
+		StateEval(const State& state, const EvalWeight& weight = default_weight(), const MaterialTable& table = default_table(), EvalCache* cache = nullptr):
+			_state(state),
+			_weight(weight),
+			_red_values(table.values(MaterialTable::Signature(state, PLAYER_BLACK))),
+			_black_values(table.values(MaterialTable::Signature(state, PLAYER_RED))),
+			_cache(cache != nullptr ? cache : (&weight == &default_weight() ? &default_cache() : nullptr))
 		{
 		}
+
+		//get the value of flipped pieces of the player on the board.
+		double alive_value(PlayerIndex player) const;
+
+		//get the expected value of hidden pieces of the player.
+		double hidden_value(PlayerIndex player) const;
+
+		//get the number of moves and captures of the player, cannon jumps are not included.
+		size_t mobility(PlayerIndex player) const;
+
+		//get the value of pieces of the player that can be captured by the opponent.
+		double threatened_value(PlayerIndex player) const;
+
+		//get the eval of the state from the view of the player without cache.
+		double eval_uncached(PlayerIndex player) const;
+
+		//get the eval of the state from the view of the player.
+		double eval(PlayerIndex player) const;
+
+		//get the probability that the player wins, which is converted from eval by logistic function.
+		double win_probability(PlayerIndex player) const;
+
+		//classify the phase of the state by hidden pieces, material and mobility.
+		//it is begining if most pieces are hidden and no piece is captured.
+		StateProcessType process_type() const;
 	};
 }
@@ -34,53 +34,67 @@ namespace chinese_dark_chess
 		constexpr const char* g_BLACK_PLAYER_STR = "BLACK";
 
 
+		bool CharToPiece(char c, PieceType& piece)
+		{
+			switch (c)
+			{
+			case '?':
+				piece = PIECE_UNKNOWN; return true;
+			case 'P':
+				piece = PIECE_RED_PAWN; return true;
+			case 'C':
+				piece = PIECE_RED_CANNON; return true;
+			case 'N':
+				piece = PIECE_RED_KNIGHT; return true;
+			case 'R':
+				piece = PIECE_RED_ROOK; return true;
+			case 'M':
+				piece = PIECE_RED_MINISTER; return true;
+			case 'G':
+				piece = PIECE_RED_GUARD; return true;
+			case 'K':
+				piece = PIECE_RED_KING; return true;
+			case 'p':
+				piece = PIECE_BLACK_PAWN; return true;
+			case 'c':
+				piece = PIECE_BLACK_CANNON; return true;
+			case 'n':
+				piece = PIECE_BLACK_KNIGHT; return true;
+			case 'r':
+				piece = PIECE_BLACK_ROOK; return true;
+			case 'm':
+				piece = PIECE_BLACK_MINISTER; return true;
+			case 'g':
+				piece = PIECE_BLACK_GUARD; return true;
+			case 'k':
+				piece = PIECE_BLACK_KING; return true;
+			case ' ':
+				piece = PIECE_EMPTY; return true;
+			default:
+				break;
+			}
+			return false;
+		}
+
 		PieceType JsonToPiece(Json json, ErrorLog & err)
 		{
 			if (json.is_string())
 			{
-				std::string str = json.string_value();
-				switch (str[0])
-				{
-				case '?':
-					return PIECE_UNKNOWN;
-				case 'P':
-					return PIECE_RED_PAWN;
-				case 'C':
-					return PIECE_RED_CANNON;
-				case 'N':
-					return PIECE_RED_KNIGHT;
-				case 'R':
-					return PIECE_RED_ROOK;
-				case 'M':
-					return PIECE_RED_MINISTER;
-				case 'G':
-					return PIECE_RED_GUARD;
-				case 'K':
-					return PIECE_RED_KING;
-				case 'p':
-					return PIECE_BLACK_PAWN;
-				case 'c':
-					return PIECE_BLACK_CANNON;
-				case 'n':
-					return PIECE_BLACK_KNIGHT;
-				case 'r':
-					return PIECE_BLACK_ROOK;
-				case 'm':
-					return PIECE_BLACK_MINISTER;
-				case 'g':
-					return PIECE_BLACK_GUARD;
-				case 'k':
-					return PIECE_BLACK_KING;
-				case ' ':
-					return PIECE_EMPTY;
-				default:
-					break;
+				PieceType piece;
+				if (CharToPiece(json.string_value()[0], piece))
+				{
+					return piece;
 				}
 			}
 			err.add("JsonToPiece failed, value = " + json.string_value());
 			return PieceType();
 		}
 
+		bool IsLegalHiddenPiece(PieceType piece, size_t count)
+		{
+			return piece >= PIECE_RED_PAWN && piece <= PIECE_BLACK_KING && count <= HiddenPiece(g_CDC_BEGINING_HIDDEN).get(piece);
+		}
+
 		PlayerIndex JsonToPlayer(Json json, ErrorLog & err)
 		{
 			if (json.is_string())
@@ -148,13 +162,26 @@ namespace chinese_dark_chess
 				}
 				else { err.add("json is not array."); }
 
+				//illegal hidden pieces are not added, since they are out of the range of HiddenPiece.
 				std::vector<PieceType> hidden_pieces;
+				size_t hidden_count[PIECE_EMPTY + 1] = { 0 };
 				const Json& hidden_pieces_json = json[g_HIDDEN_PIECE_STR];
 				if (hidden_pieces_json.is_array())
 				{
 					for (auto j : hidden_pieces_json.array_items())
 					{
-						hidden_pieces.push_back(JsonToPiece(j, err));
+						const size_t err_size = err.size();
+						const PieceType piece = JsonToPiece(j, err);
+						if (err.size() != err_size)
+						{
+							continue;
+						}
+						if (!IsLegalHiddenPiece(piece, ++hidden_count[piece]))
+						{
+							err.add("illegal hidden piece, value = " + std::string(1, PieceToChar(piece)));
+							continue;
+						}
+						hidden_pieces.push_back(piece);
 					}
 				}
 
@@ -165,6 +192,645 @@ namespace chinese_dark_chess
 			return State();
 		}
 
+		/*
+		* RequestParser parses request text by the schema of request without building json values.
+		*
+		* the syntax is checked as json11 does, values of unknown keys are skipped and the last value is used if a key is repeated.
+		* pieces are written into the board array which is used to construct state, no memory is allocated unless any string
+		* has escapes or any error exists. errors are the same as JsonToState(Json::parse(str)), so any syntax error is
+		* reported as the json is not object.
+		*/
+		class RequestParser
+		{
+		private:
+			using ErrorList = std::vector<std::string>;
+
+			//location of a string in the text, begin is after the opening quote and end is the closing quote.
+			struct StringToken
+			{
+				size_t	begin;
+				size_t	end;
+				bool	escaped;
+			};
+
+			static const int _max_depth = 200;	//the same as json11.
+
+			const std::string&	_str;
+			size_t				_i;
+			bool				_failed;
+
+			PieceType			_board[g_CDC_MAX_LENGTH];
+			size_t				_hidden_count[PIECE_EMPTY + 1];
+			PlayerIndex			_next_player;
+			bool				_board_found;
+			bool				_player_found;
+			ErrorList			_board_err;
+			ErrorList			_hidden_err;
+			ErrorList			_player_err;
+			std::string			_decoded;			//buffer of the string that has escapes.
+
+		private:
+			inline bool fail()
+			{
+				_failed = true;
+				return false;
+			}
+
+			inline void ConsumeWhitespace()
+			{
+				while (_str[_i] == ' ' || _str[_i] == '\r' || _str[_i] == '\n' || _str[_i] == '\t')
+				{
+					_i++;
+				}
+			}
+
+			//return the next non-whitespace character, or 0 if the input ends.
+			inline char NextToken()
+			{
+				ConsumeWhitespace();
+				if (_i == _str.size())
+				{
+					fail();
+					return 0;
+				}
+				return _str[_i++];
+			}
+
+			//read the first character of a value at the depth.
+			inline char BeginValue(int depth)
+			{
+				if (depth > _max_depth)
+				{
+					fail();
+					return 0;
+				}
+				return NextToken();
+			}
+
+			static inline bool IsHex(char c)
+			{
+				return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+			}
+
+			static inline long HexValue(char c)
+			{
+				return c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10;
+			}
+
+			static void EncodeUtf8(long pt, std::string& out)
+			{
+				if (pt < 0)
+				{
+					return;
+				}
+				if (pt < 0x80)
+				{
+					out += static_cast<char>(pt);
+				}
+				else if (pt < 0x800)
+				{
+					out += static_cast<char>((pt >> 6) | 0xC0);
+					out += static_cast<char>((pt & 0x3F) | 0x80);
+				}
+				else if (pt < 0x10000)
+				{
+					out += static_cast<char>((pt >> 12) | 0xE0);
+					out += static_cast<char>(((pt >> 6) & 0x3F) | 0x80);
+					out += static_cast<char>((pt & 0x3F) | 0x80);
+				}
+				else
+				{
+					out += static_cast<char>((pt >> 18) | 0xF0);
+					out += static_cast<char>(((pt >> 12) & 0x3F) | 0x80);
+					out += static_cast<char>(((pt >> 6) & 0x3F) | 0x80);
+					out += static_cast<char>((pt & 0x3F) | 0x80);
+				}
+			}
+
+			//scan a string whose opening quote has been read.
+			bool ScanString(StringToken& token)
+			{
+				token.begin = _i;
+				token.escaped = false;
+				for (;;)
+				{
+					if (_i == _str.size())
+					{
+						return fail();
+					}
+					const char ch = _str[_i++];
+					if (ch == '"')
+					{
+						token.end = _i - 1;
+						return true;
+					}
+					if (ch >= 0 && ch <= 0x1f)
+					{
+						return fail();
+					}
+					if (ch != '\\')
+					{
+						continue;
+					}
+					token.escaped = true;
+					if (_i == _str.size())
+					{
+						return fail();
+					}
+					const char esc = _str[_i++];
+					if (esc == 'u')
+					{
+						if (_str.size() - _i < 4 || !IsHex(_str[_i]) || !IsHex(_str[_i + 1]) || !IsHex(_str[_i + 2]) || !IsHex(_str[_i + 3]))
+						{
+							return fail();
+						}
+						_i += 4;
+					}
+					else if (esc != 'b' && esc != 'f' && esc != 'n' && esc != 'r' && esc != 't' && esc != '"' && esc != '\\' && esc != '/')
+					{
+						return fail();
+					}
+				}
+			}
+
+			//decode the string which has escapes, surrogate pairs are decoded as json11 does.
+			void Decode(const StringToken& token, std::string& out) const
+			{
+				out.clear();
+				long last_escaped_codepoint = -1;
+				for (size_t i = token.begin; i < token.end;)
+				{
+					char ch = _str[i++];
+					if (ch != '\\')
+					{
+						EncodeUtf8(last_escaped_codepoint, out);
+						last_escaped_codepoint = -1;
+						out += ch;
+						continue;
+					}
+					ch = _str[i++];
+					if (ch == 'u')
+					{
+						const long codepoint = (HexValue(_str[i]) << 12) | (HexValue(_str[i + 1]) << 8) | (HexValue(_str[i + 2]) << 4) | HexValue(_str[i + 3]);
+						if (last_escaped_codepoint >= 0xD800 && last_escaped_codepoint <= 0xDBFF && codepoint >= 0xDC00 && codepoint <= 0xDFFF)
+						{
+							EncodeUtf8((((last_escaped_codepoint - 0xD800) << 10) | (codepoint - 0xDC00)) + 0x10000, out);
+							last_escaped_codepoint = -1;
+						}
+						else
+						{
+							EncodeUtf8(last_escaped_codepoint, out);
+							last_escaped_codepoint = codepoint;
+						}
+						i += 4;
+						continue;
+					}
+					EncodeUtf8(last_escaped_codepoint, out);
+					last_escaped_codepoint = -1;
+					switch (ch)
+					{
+					case 'b': out += '\b'; break;
+					case 'f': out += '\f'; break;
+					case 'n': out += '\n'; break;
+					case 'r': out += '\r'; break;
+					case 't': out += '\t'; break;
+					default: out += ch; break;
+					}
+				}
+				EncodeUtf8(last_escaped_codepoint, out);
+			}
+
+			//get the value of the string, which is decoded into the buffer only if it has escapes.
+			const char* Text(const StringToken& token, size_t& length)
+			{
+				if (!token.escaped)
+				{
+					length = token.end - token.begin;
+					return _str.data() + token.begin;
+				}
+				Decode(token, _decoded);
+				length = _decoded.size();
+				return _decoded.data();
+			}
+
+			inline bool TextIs(const StringToken& token, const char* str)
+			{
+				size_t length;
+				const char* text = Text(token, length);
+				return length == strlen(str) && memcmp(text, str, length) == 0;
+			}
+
+			//expect the literal whose first character has been read.
+			bool Expect(const char* literal)
+			{
+				_i--;
+				const size_t length = strlen(literal);
+				if (_str.compare(_i, length, literal) != 0)
+				{
+					return fail();
+				}
+				_i += length;
+				return true;
+			}
+
+			bool SkipNumber()
+			{
+				if (_str[_i] == '-')
+				{
+					_i++;
+				}
+				if (_str[_i] == '0')
+				{
+					_i++;
+					if (_str[_i] >= '0' && _str[_i] <= '9')
+					{
+						return fail();
+					}
+				}
+				else if (_str[_i] >= '1' && _str[_i] <= '9')
+				{
+					while (_str[_i] >= '0' && _str[_i] <= '9')
+					{
+						_i++;
+					}
+				}
+				else
+				{
+					return fail();
+				}
+				if (_str[_i] == '.')
+				{
+					_i++;
+					if (!(_str[_i] >= '0' && _str[_i] <= '9'))
+					{
+						return fail();
+					}
+					while (_str[_i] >= '0' && _str[_i] <= '9')
+					{
+						_i++;
+					}
+				}
+				if (_str[_i] == 'e' || _str[_i] == 'E')
+				{
+					_i++;
+					if (_str[_i] == '+' || _str[_i] == '-')
+					{
+						_i++;
+					}
+					if (!(_str[_i] >= '0' && _str[_i] <= '9'))
+					{
+						return fail();
+					}
+					while (_str[_i] >= '0' && _str[_i] <= '9')
+					{
+						_i++;
+					}
+				}
+				return true;
+			}
+
+			//parse the items of an array whose opening bracket has been read, items are at depth + 1.
+			//ParseItem receives the first character of each item and returns false if the syntax is illegal.
+			template<typename ItemFunc>
+			bool ParseArray(int depth, ItemFunc ParseItem)
+			{
+				if (NextToken() == ']')
+				{
+					return true;
+				}
+				if (_failed)
+				{
+					return false;
+				}
+				_i--;
+				for (;;)
+				{
+					const char ch = BeginValue(depth + 1);
+					if (_failed || !ParseItem(ch))
+					{
+						return fail();
+					}
+					const char next = NextToken();
+					if (next == ']')
+					{
+						return true;
+					}
+					if (next != ',')
+					{
+						return fail();
+					}
+				}
+			}
+
+			//parse the members of an object whose opening brace has been read, values are at depth + 1.
+			//ParseMember receives the key and the first character of the value.
+			template<typename MemberFunc>
+			bool ParseObject(int depth, MemberFunc ParseMember)
+			{
+				char ch = NextToken();
+				if (ch == '}')
+				{
+					return true;
+				}
+				for (;;)
+				{
+					StringToken key;
+					if (ch != '"' || !ScanString(key) || NextToken() != ':')
+					{
+						return fail();
+					}
+					const char value = BeginValue(depth + 1);
+					if (_failed || !ParseMember(key, value))
+					{
+						return fail();
+					}
+					ch = NextToken();
+					if (ch == '}')
+					{
+						return true;
+					}
+					if (ch != ',')
+					{
+						return fail();
+					}
+					ch = NextToken();
+				}
+			}
+
+			//check the syntax of a value whose first character has been read.
+			bool SkipValue(char ch, int depth)
+			{
+				if (_failed)
+				{
+					return false;
+				}
+				if (ch == '-' || (ch >= '0' && ch <= '9'))
+				{
+					_i--;
+					return SkipNumber();
+				}
+				switch (ch)
+				{
+				case 't':
+					return Expect("true");
+				case 'f':
+					return Expect("false");
+				case 'n':
+					return Expect("null");
+				case '"':
+				{
+					StringToken token;
+					return ScanString(token);
+				}
+				case '{':
+					return ParseObject(depth, [&](const StringToken&, char value) { return SkipValue(value, depth + 1); });
+				case '[':
+					return ParseArray(depth, [&](char item) { return SkipValue(item, depth + 1); });
+				default:
+					break;
+				}
+				return fail();
+			}
+
+			//parse a piece as JsonToPiece does.
+			bool ParsePiece(char ch, int depth, PieceType& piece, ErrorList& err)
+			{
+				piece = PieceType();
+				if (ch != '"')
+				{
+					if (!SkipValue(ch, depth))
+					{
+						return false;
+					}
+					err.push_back("JsonToPiece failed, value = ");
+					return true;
+				}
+				StringToken token;
+				if (!ScanString(token))
+				{
+					return false;
+				}
+				size_t length;
+				const char* text = Text(token, length);
+				if (!CharToPiece(length > 0 ? text[0] : '\0', piece))
+				{
+					err.push_back("JsonToPiece failed, value = " + std::string(text, length));
+				}
+				return true;
+			}
+
+			//parse a column of the board, pieces of the column are written to the board if x is legal.
+			bool ParseColumn(char ch, size_t x)
+			{
+				if (ch != '[')
+				{
+					if (!SkipValue(ch, 2))
+					{
+						return false;
+					}
+					_board_err.push_back("arr is not array.");
+					return true;
+				}
+				const size_t err_size = _board_err.size();
+				size_t y = 0;
+				const bool legal = ParseArray(2, [&](char item) {
+					PieceType piece;
+					if (!ParsePiece(item, 3, piece, _board_err))
+					{
+						return false;
+					}
+					if (x < g_CDC_BOARD_WIDTH && y < g_CDC_BOARD_HEIGHT)
+					{
+						_board[(y * g_CDC_BOARD_WIDTH) + x] = piece;
+					}
+					y++;
+					return true;
+				});
+				if (!legal)
+				{
+					return false;
+				}
+				if (y != g_CDC_BOARD_HEIGHT)
+				{
+					_board_err.resize(err_size);
+					_board_err.push_back("json array size is not 4.");
+				}
+				return true;
+			}
+
+			bool ParseBoard(char ch)
+			{
+				_board_found = true;
+				_board_err.clear();
+				if (ch != '[')
+				{
+					if (!SkipValue(ch, 1))
+					{
+						return false;
+					}
+					_board_err.push_back("json is not array.");
+					return true;
+				}
+				size_t x = 0;
+				if (!ParseArray(1, [&](char item) { return ParseColumn(item, x++); }))
+				{
+					return false;
+				}
+				if (x != g_CDC_BOARD_WIDTH)
+				{
+					_board_err.clear();
+					_board_err.push_back("json array size is not 8.");
+				}
+				return true;
+			}
+
+			bool ParseHiddenPieces(char ch)
+			{
+				_hidden_err.clear();
+				std::fill(_hidden_count, _hidden_count + PIECE_EMPTY + 1, 0);
+				if (ch != '[')
+				{
+					return SkipValue(ch, 1);
+				}
+				return ParseArray(1, [&](char item) {
+					PieceType piece;
+					const size_t err_size = _hidden_err.size();
+					if (!ParsePiece(item, 2, piece, _hidden_err))
+					{
+						return false;
+					}
+					if (_hidden_err.size() != err_size)
+					{
+						return true;
+					}
+					if (!IsLegalHiddenPiece(piece, ++_hidden_count[piece]))
+					{
+						_hidden_err.push_back("illegal hidden piece, value = " + std::string(1, PieceToChar(piece)));
+					}
+					return true;
+				});
+			}
+
+			bool ParseNextPlayer(char ch)
+			{
+				_player_found = true;
+				_player_err.clear();
+				_next_player = PlayerIndex();
+				if (ch != '"')
+				{
+					if (!SkipValue(ch, 1))
+					{
+						return false;
+					}
+					_player_err.push_back("JsonToPlayer failed, value = ");
+					return true;
+				}
+				StringToken token;
+				if (!ScanString(token))
+				{
+					return false;
+				}
+				if (TextIs(token, g_RED_PLAYER_STR))
+				{
+					_next_player = PLAYER_RED;
+				}
+				else if (TextIs(token, g_BLACK_PLAYER_STR))
+				{
+					_next_player = PLAYER_BLACK;
+				}
+				else
+				{
+					size_t length;
+					const char* text = Text(token, length);
+					_player_err.push_back("JsonToPlayer failed, value = " + std::string(text, length));
+				}
+				return true;
+			}
+
+			//parse the request, return false if the text is not a legal json object.
+			bool ParseRequest()
+			{
+				if (BeginValue(0) != '{')
+				{
+					return fail();
+				}
+				const bool legal = ParseObject(0, [&](const StringToken& key, char value) {
+					if (TextIs(key, g_BOARD_STR))
+					{
+						return ParseBoard(value);
+					}
+					if (TextIs(key, g_HIDDEN_PIECE_STR))
+					{
+						return ParseHiddenPieces(value);
+					}
+					if (TextIs(key, g_NEXT_PLAYER_STR))
+					{
+						return ParseNextPlayer(value);
+					}
+					return SkipValue(value, 1);
+				});
+				if (!legal)
+				{
+					return false;
+				}
+				ConsumeWhitespace();
+				return _i == _str.size() || fail();
+			}
+
+		public:
+			RequestParser(const std::string& str) :
+				_str(str),
+				_i(0),
+				_failed(false),
+				_next_player(PlayerIndex()),
+				_board_found(false),
+				_player_found(false)
+			{
+				std::fill(_board, _board + g_CDC_MAX_LENGTH, PIECE_EMPTY);
+				std::fill(_hidden_count, _hidden_count + PIECE_EMPTY + 1, 0);
+			}
+
+			//parse the state, errors are added in the same order as JsonToState.
+			State Parse(ErrorLog& err)
+			{
+				if (!ParseRequest())
+				{
+					err.add("JsonToState, json is not object");
+					return State();
+				}
+				if (!_board_found)
+				{
+					_board_err.push_back("json is not array.");
+				}
+				if (!_player_found)
+				{
+					_player_err.push_back("JsonToPlayer failed, value = ");
+				}
+				if (!_board_err.empty() || !_hidden_err.empty() || !_player_err.empty())
+				{
+					for (const auto& e : _board_err) { err.add(e); }
+					for (const auto& e : _hidden_err) { err.add(e); }
+					for (const auto& e : _player_err) { err.add(e); }
+					return State();
+				}
+
+				HiddenPiece hidden;
+				for (size_t piece = 0; piece <= PIECE_EMPTY; piece++)
+				{
+					for (size_t i = 0; i < _hidden_count[piece]; i++)
+					{
+						hidden.push(piece);
+					}
+				}
+				return State(_board, hidden, _next_player);
+			}
+		};
+
+		State ParseState(const std::string & json_str, ErrorLog & err)
+		{
+			return RequestParser(json_str).Parse(err);
+		}
+
 		Json LocationToJson(Location loc)
 		{
 			Json::array arr = {
@@ -188,48 +854,53 @@ namespace chinese_dark_chess
 			return Json("");
 		}
 
-		Json PieceToJson(PieceType p)
+		char PieceToChar(PieceType p)
 		{
 			switch (p)
 			{
 			case PIECE_UNKNOWN:
-				return Json("?");
+				return '?';
 			case PIECE_UNDECIDED:
-				return Json("?");
+				return '?';
 			case PIECE_RED_PAWN:
-				return Json("P");
+				return 'P';
 			case PIECE_RED_CANNON:
-				return Json("C");
+				return 'C';
 			case PIECE_RED_KNIGHT:
-				return Json("N");
+				return 'N';
 			case PIECE_RED_ROOK:
-				return Json("R");
+				return 'R';
 			case PIECE_RED_MINISTER:
-				return Json("M");
+				return 'M';
 			case PIECE_RED_GUARD:
-				return Json("G");
+				return 'G';
 			case PIECE_RED_KING:
-				return Json("K");
+				return 'K';
 			case PIECE_BLACK_PAWN:
-				return Json("p");
+				return 'p';
 			case PIECE_BLACK_CANNON:
-				return Json("c");
+				return 'c';
 			case PIECE_BLACK_KNIGHT:
-				return Json("n");
+				return 'n';
 			case PIECE_BLACK_ROOK:
-				return Json("r");
+				return 'r';
 			case PIECE_BLACK_MINISTER:
-				return Json("m");
+				return 'm';
 			case PIECE_BLACK_GUARD:
-				return Json("g");
+				return 'g';
 			case PIECE_BLACK_KING:
-				return Json("k");
+				return 'k';
 			case PIECE_EMPTY:
-				return Json(" ");
+				return ' ';
 			default:
 				break;
 			}
-			return Json(" ");
+			return ' ';
+		}
+
+		Json PieceToJson(PieceType p)
+		{
+			return Json(std::string(1, PieceToChar(p)));
 		}
 
 		Json ActionToJson(const Action & action)
@@ -272,56 +943,206 @@ namespace chinese_dark_chess
 			return obj;
 		}
 
-		std::string ChineseDarkChessAI(std::string json_str, std::string log_dir, std::string err_dir)
+		//append the key of an object member, keys must be written in sorted order as json11 does.
+		inline void WriteKey(const char* key, bool first, std::string& out)
+		{
+			if (!first)
+			{
+				out += ", ";
+			}
+			out += '"';
+			out += key;
+			out += "\": ";
+		}
+
+		inline void WritePiece(PieceType piece, std::string& out)
+		{
+			out += '"';
+			out += PieceToChar(piece);
+			out += '"';
+		}
+
+		inline void WriteLocation(Location loc, std::string& out)
+		{
+			char buffer[32];
+			const int length = snprintf(buffer, sizeof(buffer), "[%d, %d]", (int)loc.x, (int)loc.y);
+			out.append(buffer, size_t(length));
+		}
+
+		void WriteAction(const Action & action, std::string & out)
+		{
+			out += '{';
+			WriteKey(g_ACTION_DEST_STR, true, out);
+			WriteLocation(Location(action.dest), out);
+			WriteKey(g_ACTION_SOURCE_STR, false, out);
+			WriteLocation(Location(action.source), out);
+			WriteKey(g_ACTION_PIECE_STR, false, out);
+			WritePiece(action.piece, out);
+			out += '}';
+		}
+
+		void WriteState(const State & state, std::string & out)
+		{
+			//the location is given the last piece whose board contains it, the same as StateData.
+			PieceType board[g_CDC_MAX_LENGTH];
+			std::fill(board, board + g_CDC_MAX_LENGTH, PIECE_EMPTY);
+			for (uint8_t piece = PIECE_UNKNOWN; piece < PIECE_EMPTY; piece++)
+			{
+				const uint64_t bits = state.piece_board(piece).to_ullong();
+				for (size_t index = 0; index < g_CDC_MAX_LENGTH; index++)
+				{
+					if ((bits >> index) & 1)
+					{
+						board[index] = PieceType(piece);
+					}
+				}
+			}
+
+			out += '{';
+			WriteKey(g_BOARD_STR, true, out);
+			out += '[';
+			for (size_t x = 0; x < g_CDC_BOARD_WIDTH; x++)
+			{
+				out += x == 0 ? "[" : ", [";
+				for (size_t y = 0; y < g_CDC_BOARD_HEIGHT; y++)
+				{
+					if (y != 0)
+					{
+						out += ", ";
+					}
+					WritePiece(board[(y * g_CDC_BOARD_WIDTH) + x], out);
+				}
+				out += ']';
+			}
+			out += ']';
+
+			WriteKey(g_HIDDEN_PIECE_STR, false, out);
+			out += '[';
+			const uint64_t hidden = state.hidden_pieces().to_ullong();
+			bool first = true;
+			for (size_t piece = 0; piece < state.hidden_pieces().upper_bound(); piece++)
+			{
+				for (size_t n = 0; n < ((hidden >> (piece * 4)) & 0xF); n++)
+				{
+					if (!first)
+					{
+						out += ", ";
+					}
+					WritePiece(PieceType(piece), out);
+					first = false;
+				}
+			}
+			out += ']';
+
+			WriteKey(g_NEXT_PLAYER_STR, false, out);
+			out += '"';
+			if (state.next_player() == PLAYER_RED)
+			{
+				out += g_RED_PLAYER_STR;
+			}
+			else if (state.next_player() == PLAYER_BLACK)
+			{
+				out += g_BLACK_PLAYER_STR;
+			}
+			out += "\"}";
+		}
+
+		const std::string & AIService::LogPath(const std::string & dir, const char * prefix)
+		{
+			char hour[32];
+			gadt::timer::TimeString(hour, sizeof(hour), "%m-%d-%H");
+			_log_path.assign(dir);
+			_log_path += prefix;
+			_log_path += hour;
+			_log_path += g_LOG_SUFFIX;
+			return _log_path;
+		}
+
+		void AIService::WriteLog(std::ofstream & log)
+		{
+			log.write(_log_buffer.data(), std::streamsize(_log_buffer.size()));
+			log.flush();
+		}
+
+		std::ofstream & AIService::OpenLog(std::ofstream & log, std::string & opened_path, const std::string & path)
+		{
+			if (!log.is_open() || opened_path != path)
+			{
+				log.close();
+				log.clear();
+				log.open(path, std::ios::app);
+				opened_path = path;
+			}
+			return log;
+		}
+
+		void AIService::Respond(const std::string& json_str, Engine& engine, std::string& respond)
 		{
 			ErrorLog err;
 			gadt::timer::TimePoint tm;
 
-			const std::string default_respond = "null";
-			const size_t mc_times = 10000;
+			respond.clear();
 
-			std::string parse_err;
-			Json request_json = Json::parse(json_str, parse_err);
-			
-			State state = JsonToState(request_json, err);
+			State state = ParseState(json_str, err);
 
-			//return null if exist any error.
+			//respond null if exist any error.
 			if (!err.is_empty())
 			{
-				std::ofstream err_log(err_dir + "error_" + gadt::timer::TimeString("%m-%d-%H") + g_LOG_SUFFIX, std::ios::app);
+				respond += "null";
 				if (g_PRINT_RESPOND)
 				{
 					std::cout << "FzmError: Request Failed! " << std::endl;
 				}
 				if (g_ENABLE_ERROR_LOG)
 				{
-					err_log << "Error = {" << std::endl;
-					err_log << "  request = " << json_str << std::endl;
-					err_log << "  error = " << err.output() << std::endl;
-					err_log << "  time = " << gadt::timer::TimeString() << std::endl << "}" << std::endl << std::endl;
+					std::lock_guard<std::mutex> lock(_log_mutex);
+					std::ofstream& err_log = OpenLog(_error_log, _error_log_path, LogPath(_err_dir, "error_"));
+					char time[64];
+					gadt::timer::TimeString(time, sizeof(time));
+					_log_buffer.clear();
+					_log_buffer += "Error = {\n  request = ";
+					_log_buffer += json_str;
+					_log_buffer += "\n  error = ";
+					_log_buffer += err.output();
+					_log_buffer += "\n  time = ";
+					_log_buffer += time;
+					_log_buffer += "\n}\n\n";
+					WriteLog(err_log);
 				}
-				return default_respond;
+				return;
 			}
 
-			MonteCarlo mc(state);
-			Action act = mc.DoMonteCarlo(mc_times);
-			std::string respond_str = ActionToJson(act).dump();
+			Action act = engine.DoSearch(state);
+			WriteAction(act, respond);
 
 			//write logs.
 			if (g_PRINT_RESPOND)
 			{
-				std::cout << respond_str << std::endl;
+				std::cout << respond << std::endl;
 			}
 
 			if (g_ENABLE_REQUEST_LOG)
 			{
-				std::ofstream log(log_dir + "Req_" + gadt::timer::TimeString("%m-%d-%H") + g_LOG_SUFFIX, std::ios::app);
-				log << "{" << std::endl;
-				log << "  \"request\":" << json_str << "," << std::endl;
-				log << "  \"respond\":" << respond_str << "," << std::endl;
-				log << "  \"time\":\"" << gadt::timer::TimeString() << "\"" << std::endl << "}," << std::endl << std::endl;
+				std::lock_guard<std::mutex> lock(_log_mutex);
+				std::ofstream& log = OpenLog(_request_log, _request_log_path, LogPath(_log_dir, "Req_"));
+				char time[64];
+				gadt::timer::TimeString(time, sizeof(time));
+				_log_buffer.clear();
+				_log_buffer += "{\n  \"request\":";
+				_log_buffer += json_str;
+				_log_buffer += ",\n  \"respond\":";
+				_log_buffer += respond;
+				_log_buffer += ",\n  \"time\":\"";
+				_log_buffer += time;
+				_log_buffer += "\"\n},\n\n";
+				WriteLog(log);
 			}
-			return respond_str;
+		}
+
+		std::string ChineseDarkChessAI(std::string json_str, std::string log_dir, std::string err_dir)
+		{
+			AIService service(log_dir, err_dir);
+			return service.Respond(json_str);
 		}
 	}
 }
@@ -1,5 +1,6 @@
 #include "cdc_define.h"
 #include "monte_carlo.h"
+#include "cdc_engine.h"
 #include "../include/json11.hpp"
 
 #pragma once
@@ -11,24 +12,112 @@ namespace chinese_dark_chess
 {
 	namespace json_interface
 	{
+		//get piece by its character in json, return false if the character is illegal.
+		bool CharToPiece(char c, PieceType& piece);
+
 		PieceType JsonToPiece(Json json, ErrorLog& err);
 
+		//return true if the piece could be hidden and its count is no more than the begining, the count includes the piece itself.
+		bool IsLegalHiddenPiece(PieceType piece, size_t count);
+
 		PlayerIndex JsonToPlayer(Json json, ErrorLog& err);
 
 		Location JsonToLocation(Json json, ErrorLog& err);
 
 		State JsonToState(Json json, ErrorLog& err);
 
+		//parse request text to state without building json values, errors are the same as JsonToState(Json::parse(json_str)).
+		State ParseState(const std::string& json_str, ErrorLog& err);
+
 		Json LocationToJson(Location loc);
 
 		Json PlayerToJson(PlayerIndex p);
 
+		//get the character of piece in json.
+		char PieceToChar(PieceType p);
+
 		Json PieceToJson(PieceType p);
 
 		Json ActionToJson(const Action& action);
 
 		Json StateToJson(const State& state);
 
+		//append the json of action to the string, which is the same as ActionToJson(action).dump().
+		void WriteAction(const Action& action, std::string& out);
+
+		//append the json of state to the string, which is the same as StateToJson(state).dump().
+		void WriteState(const State& state, std::string& out);
+
+		/*
+		* AIService responds requests by a persistent engine.
+		*
+		* the engine is created by the first request that uses it, its tables and node pool are created by the first search that needs them,
+		* and all of them are kept between requests. log files are kept open until the hour in their names changes.
+		* the response of a request is the same as ChineseDarkChessAI, responses and log records are written into reused buffers.
+		* requests could be responded by threads concurrently if each thread has its own engine, logs are written under a lock.
+		*/
+		class AIService
+		{
+		private:
+			std::string		_log_dir;
+			std::string		_err_dir;
+			EngineSetting	_setting;
+			std::unique_ptr<Engine>	_engine;	//engine of the service, which is created by the first request that uses it.
+			std::mutex		_log_mutex;
+			std::ofstream	_request_log;
+			std::ofstream	_error_log;
+			std::string		_request_log_path;
+			std::string		_error_log_path;
+			std::string		_log_path;		//buffer of the path of log, used under the lock.
+			std::string		_log_buffer;	//buffer of a log record, used under the lock.
+
+		private:
+			//get the log file of the path, which is reopened if the path changes.
+			static std::ofstream& OpenLog(std::ofstream& log, std::string& opened_path, const std::string& path);
+
+			//get the path of the log file of this hour in the dir.
+			const std::string& LogPath(const std::string& dir, const char* prefix);
+
+			//write the record in the buffer to the log by one write and one flush.
+			void WriteLog(std::ofstream& log);
+
+		public:
+			AIService(std::string log_dir, std::string err_dir, EngineSetting setting = EngineSetting()) :
+				_log_dir(log_dir),
+				_err_dir(err_dir),
+				_setting(setting),
+				_engine()
+			{
+			}
+
+			//get the setting of engines.
+			const EngineSetting& setting() const
+			{
+				return _setting;
+			}
+
+			//get the response of the request by the engine of the service.
+			std::string Respond(const std::string& json_str)
+			{
+				if (!_engine)
+				{
+					_engine.reset(new Engine(_setting));
+				}
+				return Respond(json_str, *_engine);
+			}
+
+			//get the response of the request by the appointed engine.
+			std::string Respond(const std::string& json_str, Engine& engine)
+			{
+				std::string respond;
+				Respond(json_str, engine, respond);
+				return respond;
+			}
+
+			//write the response of the request to the string by the appointed engine, the string is cleared at first.
+			void Respond(const std::string& json_str, Engine& engine, std::string& respond);
+		};
+
 		std::string ChineseDarkChessAI(std::string json_str, std::string log_dir, std::string err_dir);
 	}
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "cdc_define.h"
 #include "cdc_policy.hpp"
 #include "cdc_interface.h"
+#include "cdc_tune.h"
+#include "cdc_server.h"
 
 using namespace gadt;
 using namespace chinese_dark_chess;
@@ -48,6 +50,75 @@ void ShellDefine()
 		ofs << "}";
 	});
 
+	root->AddFunction("import", "import request logs to position cache, import <cache> <log>...", [](const shell::ParamsList& params) {
+		const size_t playout_count = 16;
+		tune::PositionCache cache;
+		if (!cache.load_if_exist(params[0]))
+		{
+			std::cout << "failed to load " << params[0] << ", the cache is not changed." << std::endl;
+			return;
+		}
+		for (size_t i = 1; i < params.size(); i++)
+		{
+			ErrorLog err;
+			size_t added = tune::ImportRequestLog(params[i], playout_count, cache, err);
+			std::cout << params[i] << ": " << added << " positions added." << std::endl;
+			if (!err.is_empty())
+			{
+				std::cout << err.output() << std::endl;
+			}
+		}
+		if (!cache.save(params[0]))
+		{
+			std::cout << "failed to save " << params[0] << std::endl;
+		}
+	}, [](const shell::ParamsList& params)->bool { return params.size() >= 2; });
+	root->AddFunction("selfplay", "add self-play positions to position cache, selfplay <cache> <games>", [](const shell::ParamsList& params) {
+		EngineSetting setting;
+		setting.begining_timeout = 0.1;
+		setting.battle_timeout = 0.5;
+		setting.dead_timeout = 0.5;
+		tune::PositionCache cache;
+		if (!cache.load_if_exist(params[0]))
+		{
+			std::cout << "failed to load " << params[0] << ", the cache is not changed." << std::endl;
+			return;
+		}
+		size_t added = tune::SelfPlay(std::stoul(params[1]), setting, cache);
+		std::cout << added << " positions added, " << cache.size() << " positions in cache." << std::endl;
+		if (!cache.save(params[0]))
+		{
+			std::cout << "failed to save " << params[0] << std::endl;
+		}
+	}, [](const shell::ParamsList& params)->bool { return params.size() == 2; });
+	root->AddFunction("nnue", "load NNUE network, nnue <path>", [](const shell::ParamsList& params) {
+		if (nnue::LoadNetwork(params[0]))
+		{
+			std::cout << "network loaded." << std::endl;
+		}
+		else
+		{
+			std::cout << "failed to load " << params[0] << std::endl;
+		}
+	}, [](const shell::ParamsList& params)->bool { return params.size() == 1; });
+	root->AddFunction("tune", "tune eval weights by position cache, tune <cache> [iterations]", [](const shell::ParamsList& params) {
+		tune::PositionCache cache;
+		if (!cache.load(params[0]) || cache.size() == 0)
+		{
+			std::cout << "no position in " << params[0] << std::endl;
+			return;
+		}
+		tune::TuneSetting setting;
+		if (params.size() > 1)
+		{
+			setting.max_iteration = std::stoul(params[1]);
+		}
+		tune::EvalTuner tuner(cache, setting);
+		std::cout << cache.size() << " positions, initial loss = " << tuner.Loss(StateEval::default_weight()) << std::endl;
+		EvalWeight weight = tuner.Tune(StateEval::default_weight());
+		std::cout << "final loss = " << tuner.Loss(weight) << std::endl << tune::WeightToString(weight);
+	}, [](const shell::ParamsList& params)->bool { return params.size() == 1 || params.size() == 2; });
+
 	game->AddFunction("show", "show state",[](State& state)->void{print::PrintState(state); });
 	game->AddFunction("change", "change piece", [](State& state)->void {});
 	game->AddFunction("list", "list all possible moves", [](State& state)->void {
@@ -74,21 +145,86 @@ void ShellDefine()
 	});
 	game->AddFunction("json", "translate to json then be back", [](State& state) {
 		gadt::log::ErrorLog err;
-		auto json = json_interface::StateToJson(state);
-		State temp = json_interface::JsonToState(json, err);
+		std::string json;
+		json_interface::WriteState(state, json);
+		State temp = json_interface::ParseState(json, err);
 		print::PrintState(state);
 		print::PrintState(temp);
-		std::cout << json.dump() << std::endl;
-		std::string action_json = json_interface::ChineseDarkChessAI(json.dump(), "./", "./");
+		std::cout << json << std::endl;
+		std::string action_json = json_interface::ChineseDarkChessAI(json, "./", "./");
 		std::cout << action_json << std::endl;
 	});
 
 	cdc.StartFromPage("root");
 }
 
-int main()
+//server mode, --server reads requests from stdin, --socket <path> listens on unix domain socket.
+//--nnue <path> loads network and --log <dir> appoints the dir of logs.
+//--threads <n> appoints the number of workers and --queue <n> appoints the max number of queued requests.
+int ServerMain(int argc, char* argv[])
+{
+	//stdin and stdout may be the request stream, so warnings must not write to stdout or wait for input.
+	gadt::console::SetQuietWarning(true);
+	std::string socket_path;
+	std::string log_dir = "./";
+	size_t worker_count = std::max<size_t>(1, std::thread::hardware_concurrency());
+	size_t queue_capacity = 64;
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string arg = argv[i];
+		if (arg == "--socket" && i + 1 < argc)
+		{
+			socket_path = argv[++i];
+		}
+		else if (arg == "--log" && i + 1 < argc)
+		{
+			log_dir = argv[++i];
+		}
+		else if (arg == "--threads" && i + 1 < argc)
+		{
+			worker_count = std::max(1, atoi(argv[++i]));
+		}
+		else if (arg == "--queue" && i + 1 < argc)
+		{
+			queue_capacity = std::max(1, atoi(argv[++i]));
+		}
+		else if (arg == "--nnue" && i + 1 < argc)
+		{
+			if (!nnue::LoadNetwork(argv[++i]))
+			{
+				std::cerr << "failed to load " << argv[i] << std::endl;
+				return 1;
+			}
+		}
+		else if (arg != "--server")
+		{
+			std::cerr << "unknown argument " << arg << std::endl;
+			return 1;
+		}
+	}
+
+	json_interface::AIService service(log_dir, log_dir);
+	server::RequestPool pool(service, worker_count, queue_capacity);
+	if (socket_path.empty())
+	{
+		std::ios::sync_with_stdio(false);
+		server::ServeStream(pool, std::cin, std::cout);
+		return 0;
+	}
+	if (!server::ServeSocket(pool, socket_path))
+	{
+		std::cerr << "failed to listen on " << socket_path << std::endl;
+		return 1;
+	}
+	return 0;
+}
+
+int main(int argc, char* argv[])
 {
-	chinese_dark_chess::State s;
+	if (argc > 1)
+	{
+		return ServerMain(argc, argv);
+	}
 	ShellDefine();
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,211 @@
+#include "cdc_nnue.h"
+
+//AVX2 is used by the accumulator and inference kernels if the target supports it.
+#if defined(__AVX2__)
+	#define CDC_NNUE_AVX2
+	#include <immintrin.h>
+#endif
+
+namespace chinese_dark_chess
+{
+	namespace nnue
+	{
+		std::unique_ptr<Network>	g_active_network;			//active network.
+		uint32_t					g_active_generation = 0;	//generation of active network.
+		uint32_t					g_last_generation = 0;		//the last generation that was given to a network.
+
+		uint32_t ActiveGeneration()
+		{
+			return g_active_generation;
+		}
+
+		void ResetAccumulator(Accumulator & accumulator)
+		{
+			memcpy(accumulator.values, g_active_network->feature_bias, sizeof(accumulator.values));
+			accumulator.generation = g_active_generation;
+		}
+
+		void AddFeature(Accumulator & accumulator, size_t feature)
+		{
+			const int16_t* weights = g_active_network->feature_weights[feature];
+#ifdef CDC_NNUE_AVX2
+			for (size_t i = 0; i < g_NNUE_ACCUMULATOR_SIZE; i += 16)
+			{
+				__m256i* values = reinterpret_cast<__m256i*>(accumulator.values + i);
+				const __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i));
+				_mm256_storeu_si256(values, _mm256_add_epi16(_mm256_loadu_si256(values), w));
+			}
+#else
+			for (size_t i = 0; i < g_NNUE_ACCUMULATOR_SIZE; i++)
+			{
+				accumulator.values[i] += weights[i];
+			}
+#endif
+		}
+
+		void RemoveFeature(Accumulator & accumulator, size_t feature)
+		{
+			const int16_t* weights = g_active_network->feature_weights[feature];
+#ifdef CDC_NNUE_AVX2
+			for (size_t i = 0; i < g_NNUE_ACCUMULATOR_SIZE; i += 16)
+			{
+				__m256i* values = reinterpret_cast<__m256i*>(accumulator.values + i);
+				const __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i));
+				_mm256_storeu_si256(values, _mm256_sub_epi16(_mm256_loadu_si256(values), w));
+			}
+#else
+			for (size_t i = 0; i < g_NNUE_ACCUMULATOR_SIZE; i++)
+			{
+				accumulator.values[i] -= weights[i];
+			}
+#endif
+		}
+
+		bool LoadNetwork(const std::string & path)
+		{
+			std::ifstream ifs(path, std::ios::binary);
+			if (!ifs)
+			{
+				return false;
+			}
+			char magic[4];
+			uint32_t version = 0;
+			ifs.read(magic, sizeof(magic));
+			ifs.read(reinterpret_cast<char*>(&version), sizeof(version));
+			if (!ifs || memcmp(magic, g_NNUE_MAGIC, sizeof(magic)) != 0 || version != g_NNUE_VERSION)
+			{
+				return false;
+			}
+
+			std::unique_ptr<Network> network(new Network);
+			ifs.read(reinterpret_cast<char*>(network->feature_weights), sizeof(network->feature_weights));
+			ifs.read(reinterpret_cast<char*>(network->feature_bias), sizeof(network->feature_bias));
+			ifs.read(reinterpret_cast<char*>(network->hidden_weights), sizeof(network->hidden_weights));
+			ifs.read(reinterpret_cast<char*>(network->hidden_bias), sizeof(network->hidden_bias));
+			ifs.read(reinterpret_cast<char*>(network->output_weights), sizeof(network->output_weights));
+			ifs.read(reinterpret_cast<char*>(&network->output_bias), sizeof(network->output_bias));
+			if (!ifs)
+			{
+				return false;
+			}
+			SetNetwork(std::move(network));
+			return true;
+		}
+
+		bool SaveNetwork(const Network & network, const std::string & path)
+		{
+			std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+			if (!ofs)
+			{
+				return false;
+			}
+			const uint32_t version = g_NNUE_VERSION;
+			ofs.write(g_NNUE_MAGIC, 4);
+			ofs.write(reinterpret_cast<const char*>(&version), sizeof(version));
+			ofs.write(reinterpret_cast<const char*>(network.feature_weights), sizeof(network.feature_weights));
+			ofs.write(reinterpret_cast<const char*>(network.feature_bias), sizeof(network.feature_bias));
+			ofs.write(reinterpret_cast<const char*>(network.hidden_weights), sizeof(network.hidden_weights));
+			ofs.write(reinterpret_cast<const char*>(network.hidden_bias), sizeof(network.hidden_bias));
+			ofs.write(reinterpret_cast<const char*>(network.output_weights), sizeof(network.output_weights));
+			ofs.write(reinterpret_cast<const char*>(&network.output_bias), sizeof(network.output_bias));
+			return bool(ofs);
+		}
+
+		void SetNetwork(std::unique_ptr<Network> network)
+		{
+			g_active_network = std::move(network);
+			g_active_generation = g_active_network ? ++g_last_generation : 0;
+		}
+
+		const Network * ActiveNetwork()
+		{
+			return g_active_network.get();
+		}
+
+		//clipped ReLU.
+		inline int32_t Activate(int32_t value)
+		{
+			return std::min(std::max(value, 0), g_NNUE_ACTIVATION_MAX);
+		}
+
+		//get output from the activated hidden layer.
+		inline int32_t Output(const Network& network, const int32_t* hidden)
+		{
+			int32_t output = network.output_bias;
+			for (size_t i = 0; i < g_NNUE_HIDDEN_SIZE; i++)
+			{
+				output += hidden[i] * network.output_weights[i];
+			}
+			return output;
+		}
+
+		int32_t PropagateScalar(const Network & network, const Accumulator & accumulator)
+		{
+			int32_t input[g_NNUE_ACCUMULATOR_SIZE];
+			for (size_t i = 0; i < g_NNUE_ACCUMULATOR_SIZE; i++)
+			{
+				input[i] = Activate(accumulator.values[i]);
+			}
+			int32_t hidden[g_NNUE_HIDDEN_SIZE];
+			for (size_t n = 0; n < g_NNUE_HIDDEN_SIZE; n++)
+			{
+				int32_t sum = network.hidden_bias[n];
+				for (size_t i = 0; i < g_NNUE_ACCUMULATOR_SIZE; i++)
+				{
+					sum += input[i] * network.hidden_weights[n][i];
+				}
+				hidden[n] = Activate(sum >> g_NNUE_HIDDEN_SHIFT);
+			}
+			return Output(network, hidden);
+		}
+
+		int32_t Propagate(const Network & network, const Accumulator & accumulator)
+		{
+#ifdef CDC_NNUE_AVX2
+			static_assert(g_NNUE_ACCUMULATOR_SIZE == 32, "the AVX2 kernel requires 32 accumulator values.");
+
+			//clipped ReLU of 32 values to unsigned bytes, packing interleaves 128-bit lanes so they are permuted back.
+			const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(accumulator.values));
+			const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(accumulator.values + 16));
+			__m256i input = _mm256_packus_epi16(low, high);
+			input = _mm256_min_epu8(input, _mm256_set1_epi8(g_NNUE_ACTIVATION_MAX));
+			input = _mm256_permute4x64_epi64(input, 0xD8);
+
+			//the products of bytes are added in pairs without saturation since the inputs are no more than 127.
+			const __m256i ones = _mm256_set1_epi16(1);
+			int32_t hidden[g_NNUE_HIDDEN_SIZE];
+			for (size_t n = 0; n < g_NNUE_HIDDEN_SIZE; n++)
+			{
+				const __m256i weights = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(network.hidden_weights[n]));
+				const __m256i sums = _mm256_madd_epi16(_mm256_maddubs_epi16(input, weights), ones);
+				__m128i sum = _mm_add_epi32(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+				sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+				sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+				hidden[n] = Activate((network.hidden_bias[n] + _mm_cvtsi128_si32(sum)) >> g_NNUE_HIDDEN_SHIFT);
+			}
+			return Output(network, hidden);
+#else
+			return PropagateScalar(network, accumulator);
+#endif
+		}
+
+		double Evaluate(const State & state, PlayerIndex player)
+		{
+			const Network& network = *g_active_network;
+			int32_t output = 0;
+			if (state.accumulator().generation == g_active_generation)
+			{
+				output = Propagate(network, state.accumulator());
+			}
+			else
+			{
+				//the state is created before the network is loaded.
+				State temp = state;
+				temp.refresh_accumulator();
+				output = Propagate(network, temp.accumulator());
+			}
+			const double value = output / g_NNUE_OUTPUT_SCALE;
+			return player == PLAYER_RED ? value : -value;
+		}
+	}
+}
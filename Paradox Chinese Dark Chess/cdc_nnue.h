@@ -0,0 +1,68 @@
+#include "cdc_define.h"
+
+#pragma once
+
+namespace chinese_dark_chess
+{
+	namespace nnue
+	{
+		constexpr const char*	g_NNUE_MAGIC = "CDCN";			//magic of network file.
+		constexpr const uint32_t g_NNUE_VERSION = 1;				//version of network file.
+		constexpr const size_t	g_NNUE_HIDDEN_SIZE = 32;		//size of the hidden layer.
+		constexpr const int		g_NNUE_HIDDEN_SHIFT = 6;		//right shift of the sums of hidden layer.
+		constexpr const int		g_NNUE_ACTIVATION_MAX = 127;	//max value of clipped ReLU.
+		constexpr const double	g_NNUE_OUTPUT_SCALE = 256;		//output divided by it is the eval in units of piece value.
+		constexpr const double	g_NNUE_LOGISTIC_SCALE = 10;		//scale of the logistic function that converts the eval to win probability.
+
+		/*
+		* Network is a quantized value network whose input is the pieces in each location, hidden piece counts and next player.
+		*
+		* layers: features -> accumulator(int16, 32) -> clipped ReLU -> hidden(int8 weights, 32) -> clipped ReLU -> output(int8 weights, 1).
+		* the accumulator is the sum of the weights of active features, which is kept in State and updated incrementally.
+		* the output is the eval from the view of red player.
+		*/
+		struct Network
+		{
+			int16_t feature_weights[g_NNUE_FEATURE_COUNT][g_NNUE_ACCUMULATOR_SIZE];
+			int16_t feature_bias[g_NNUE_ACCUMULATOR_SIZE];
+			int8_t	hidden_weights[g_NNUE_HIDDEN_SIZE][g_NNUE_ACCUMULATOR_SIZE];
+			int32_t	hidden_bias[g_NNUE_HIDDEN_SIZE];
+			int8_t	output_weights[g_NNUE_HIDDEN_SIZE];
+			int32_t	output_bias;
+		};
+
+		//load network from file and make it active, return false if the file is illegal.
+		//the network must not be changed while any search is running.
+		bool LoadNetwork(const std::string& path);
+
+		//save network to file, file format: magic(4 bytes), version(uint32), layers in the order of Network.
+		bool SaveNetwork(const Network& network, const std::string& path);
+
+		//make the network active, accumulators computed by previous network are invalid.
+		void SetNetwork(std::unique_ptr<Network> network);
+
+		//get the active network, nullptr if no network is loaded.
+		const Network* ActiveNetwork();
+
+		//return true if any network is loaded.
+		inline bool Enabled()
+		{
+			return ActiveGeneration() != 0;
+		}
+
+		//get the output of the network by accumulator, AVX2 is used if the target supports it.
+		int32_t Propagate(const Network& network, const Accumulator& accumulator);
+
+		//get the output of the network by accumulator without SIMD.
+		int32_t PropagateScalar(const Network& network, const Accumulator& accumulator);
+
+		//get the eval of the state from the view of the player, the network must be loaded.
+		double Evaluate(const State& state, PlayerIndex player);
+
+		//get the win probability of the player by the eval of the network, the network must be loaded.
+		inline double WinProbability(const State& state, PlayerIndex player)
+		{
+			return 1 / (1 + std::exp(-Evaluate(state, player) / g_NNUE_LOGISTIC_SCALE));
+		}
+	}
+}
@@ -0,0 +1,141 @@
+#include "cdc_ordering.h"
+
+namespace chinese_dark_chess
+{
+	//MVV-LVA score of captures, indexed by rank of attacker and rank of victim, the last victim is unknown piece.
+	//illegal captures are 0. the pawn can capture the king but the king can not capture the pawn,
+	//and the cannon can capture any piece or unknown piece by jumping.
+	const int g_MVV_LVA[7][8] = {
+		//pawn	cannon	knight	rook	minister	guard	king	unknown
+		{ 19,	0,		0,		0,		0,			0,		79,		0 },	//pawn
+		{ 18,	48,		28,		38,		58,			68,		78,		38 },	//cannon
+		{ 17,	47,		27,		0,		0,			0,		0,		0 },	//knight
+		{ 16,	46,		26,		36,		0,			0,		0,		0 },	//rook
+		{ 15,	45,		25,		35,		55,			0,		0,		0 },	//minister
+		{ 14,	44,		24,		34,		54,			64,		0,		0 },	//guard
+		{ 0,	43,		23,		33,		53,			63,		73,		0 }		//king
+	};
+
+	//get rank of a piece, the rank of unknown piece is 7.
+	inline size_t PieceRank(PieceType piece)
+	{
+		if (piece >= PIECE_BLACK_PAWN && piece <= PIECE_BLACK_KING)
+			return piece - PIECE_BLACK_PAWN;
+		if (piece >= PIECE_RED_PAWN && piece <= PIECE_RED_KING)
+			return piece - PIECE_RED_PAWN;
+		return 7;
+	}
+
+	MoveOrdering::MoveOrdering()
+	{
+		clear();
+	}
+
+	void MoveOrdering::HalveHistory()
+	{
+		for (size_t source = 0; source < g_CDC_MAX_LENGTH; source++)
+		{
+			for (size_t dest = 0; dest < g_CDC_MAX_LENGTH; dest++)
+			{
+				_history[source][dest].store(_history[source][dest].load(std::memory_order_relaxed) / 2, std::memory_order_relaxed);
+			}
+		}
+	}
+
+	int MoveOrdering::MvvLva(const State & state, const Action & action)
+	{
+		const PieceType attacker = state.piece_at(action.source);
+		const PieceType victim = state.piece_at(action.dest);
+		const size_t attacker_rank = PieceRank(attacker);
+		if (attacker_rank == 7)
+		{
+			return 0;
+		}
+		const int score = g_MVV_LVA[attacker_rank][PieceRank(victim)];
+
+		//both pieces are removed if the action piece is empty, which is just an exchange.
+		return action.piece == PIECE_EMPTY ? score / 10 : score;
+	}
+
+	MoveOrdering::EvalValue MoveOrdering::priority(const State & state, const Action & action, size_t ply) const
+	{
+		switch (action.type)
+		{
+		case CAPTURE_ACTION:
+			return _capture_priority + MvvLva(state, action);
+		case MOVE_ACTION:
+		case FLIPPING_ACTION:
+		{
+			if (ply < g_CDC_MAX_SEARCH_PLY)
+			{
+				const uint32_t key = ActionKey(action);
+				for (size_t i = 0; i < _killer_count; i++)
+				{
+					if (_killers[ply][i].load(std::memory_order_relaxed) == key)
+					{
+						return _killer_priority + EvalValue(_killer_count - i);
+					}
+				}
+			}
+			return EvalValue(_history[action.source][action.dest].load(std::memory_order_relaxed));
+		}
+		default:
+			//the order of chance actions makes no difference.
+			return 0;
+		}
+	}
+
+	void MoveOrdering::record_cutoff(const State &, const Action & action, size_t ply, size_t depth)
+	{
+		//captures are already ordered by MVV-LVA.
+		if (action.type != MOVE_ACTION && action.type != FLIPPING_ACTION)
+		{
+			return;
+		}
+
+		//update killer moves.
+		const uint32_t key = ActionKey(action);
+		if (ply < g_CDC_MAX_SEARCH_PLY && _killers[ply][0].load(std::memory_order_relaxed) != key)
+		{
+			_killers[ply][1].store(_killers[ply][0].load(std::memory_order_relaxed), std::memory_order_relaxed);
+			_killers[ply][0].store(key, std::memory_order_relaxed);
+		}
+
+		//update history, deeper cut off is more important.
+		const uint32_t value = _history[action.source][action.dest].fetch_add(uint32_t(depth * depth), std::memory_order_relaxed);
+		if (value + depth * depth > _max_history)
+		{
+			HalveHistory();
+		}
+	}
+
+	void MoveOrdering::new_search()
+	{
+		for (size_t ply = 0; ply < g_CDC_MAX_SEARCH_PLY; ply++)
+		{
+			for (size_t i = 0; i < _killer_count; i++)
+			{
+				_killers[ply][i].store(_no_killer, std::memory_order_relaxed);
+			}
+		}
+		HalveHistory();
+	}
+
+	void MoveOrdering::clear()
+	{
+		for (size_t ply = 0; ply < g_CDC_MAX_SEARCH_PLY; ply++)
+		{
+			for (size_t i = 0; i < _killer_count; i++)
+			{
+				_killers[ply][i].store(_no_killer, std::memory_order_relaxed);
+			}
+		}
+		for (size_t source = 0; source < g_CDC_MAX_LENGTH; source++)
+		{
+			for (size_t dest = 0; dest < g_CDC_MAX_LENGTH; dest++)
+			{
+				_history[source][dest].store(0, std::memory_order_relaxed);
+			}
+		}
+	}
+}
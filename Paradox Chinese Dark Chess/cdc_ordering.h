@@ -0,0 +1,61 @@
+#include "cdc_define.h"
+
+#pragma once
+
+namespace chinese_dark_chess
+{
+	constexpr const size_t g_CDC_MAX_SEARCH_PLY = 128;
+
+	/*
+	* MoveOrdering gives the priority of actions for alpha-beta search.
+	*
+	* captures are sorted by MVV-LVA, then killer moves of the ply, then other moves by history.
+	* killer moves and history are recorded when an action causes a cut off. they are saved in relaxed atomics,
+	* so that the ordering can be shared by threads of Lazy SMP.
+	*/
+	class MoveOrdering
+	{
+	public:
+		using EvalValue = gadt::minimax::EvalValue;
+
+	private:
+		static constexpr const size_t		_killer_count = 2;
+		static constexpr const uint32_t		_no_killer = 0xFFFFFFFF;
+		static constexpr const uint32_t		_max_history = 1 << 20;
+		static constexpr const EvalValue	_capture_priority = 3000000;
+		static constexpr const EvalValue	_killer_priority = 2000000;
+
+		std::atomic<uint32_t> _killers[g_CDC_MAX_SEARCH_PLY][_killer_count];		//killer moves of each ply.
+		std::atomic<uint32_t> _history[g_CDC_MAX_LENGTH][g_CDC_MAX_LENGTH];		//history of each source and dest.
+
+	private:
+		//get the key of an action.
+		static inline uint32_t ActionKey(const Action& action)
+		{
+			return uint32_t(action.type) | (uint32_t(action.source) << 8) | (uint32_t(action.dest) << 16) | (uint32_t(action.piece) << 24);
+		}
+
+		//halve all history.
+		void HalveHistory();
+
+	public:
+		MoveOrdering();
+
+		MoveOrdering(const MoveOrdering&) = delete;
+
+		//get the MVV-LVA score of a capture action, higher is better.
+		static int MvvLva(const State& state, const Action& action);
+
+		//get the priority of an action in the ply, which can be used as ActionPriority of minimax search.
+		EvalValue priority(const State& state, const Action& action, size_t ply) const;
+
+		//record the action that causes a cut off, which can be used as RecordCutoff of minimax search.
+		void record_cutoff(const State& state, const Action& action, size_t ply, size_t depth);
+
+		//clear killer moves and halve history before a new search.
+		void new_search();
+
+		//clear all killer moves and history.
+		void clear();
+	};
+}
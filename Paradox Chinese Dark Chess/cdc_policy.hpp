@@ -10,7 +10,8 @@ namespace chinese_dark_chess
 	{
 		DEFAULT_POLICY = 0,
 		GREEDY_POLICY = 1,
-		NO_FLIPPING_POLICY =2
+		NO_FLIPPING_POLICY =2,
+		CAPTURE_ONLY_POLICY = 3		//only captures and cannon flies, used by quiescence search.
 	};
 
 	//action generator.
@@ -73,30 +74,12 @@ namespace chinese_dark_chess
 				{
 					if (cannon_board[i] == true)
 					{
-						constexpr int dir[4] = { 1,-1,8,-8 };
-						for (size_t n = 0; n < 4; n++)
+						uint64_t target_board = CannonFlyBoard(i, exist_piece_board.to_ullong()) & capturable_board.to_ullong();
+						while (target_board != 0)
 						{
-							int loc = (int)i;
-							bool found_first = false;
-							for (;;)
-							{
-								loc += dir[n];//get new location.
-								if (loc < 0 || loc >= 32)
-									break;
-								if (exist_piece_board[loc] == true)
-								{
-									if (!found_first)
-										found_first = true;
-									else
-									{
-										if (capturable_board[loc] == true)
-										{
-											AddAction({ CAPTURE_ACTION,i,loc,PieceType(_self_pawn_id + 1) });
-										}
-										break;
-									}
-								}
-							}
+							const size_t loc = gadt::stl::TrailingZeroCount(target_board);
+							target_board &= target_board - 1;
+							AddAction({ CAPTURE_ACTION,i,loc,PieceType(_self_pawn_id + 1) });
 						}
 					}
 				}
@@ -191,6 +174,9 @@ namespace chinese_dark_chess
 				GenerateAllCaptureAction();
 				GenerateAllMoveAction();
 				break;
+			case chinese_dark_chess::CAPTURE_ONLY_POLICY:
+				GenerateAllCaptureAction();
+				break;
 			default:
 				break;
 			}
@@ -305,4 +291,80 @@ namespace chinese_dark_chess
 			return action(index);
 		}
 	};
+
+	//get the locations that are adjacent to any location of the board.
+	inline uint64_t AdjacentBoard(uint64_t board)
+	{
+		constexpr uint64_t first_column = 0x01010101;
+		constexpr uint64_t last_column = 0x80808080;
+		return (((board >> 1) & ~last_column) | ((board << 1) & ~first_column) | (board >> 8) | (board << 8)) & 0xFFFFFFFF;
+	}
+
+	//return true if any action exists, which is the same as ActionGenerator(state).size() != 0 without generating actions.
+	inline bool ExistAction(const State& state)
+	{
+		if (state.exist_undecided_piece() || state.remove_hidden_flag())
+		{
+			return state.hidden_pieces().to_ullong() != 0;
+		}
+		if (state.piece_board(PIECE_UNKNOWN).any())
+		{
+			return true;
+		}
+
+		const size_t self_pawn_id = state.next_player() == PLAYER_RED ? PIECE_RED_PAWN : PIECE_BLACK_PAWN;
+		const size_t enemy_pawn_id = state.next_player() == PLAYER_RED ? PIECE_BLACK_PAWN : PIECE_RED_PAWN;
+		uint64_t self[7];
+		uint64_t enemy[7];
+		uint64_t enemy_board = 0;
+		for (size_t i = 0; i < 7; i++)
+		{
+			self[i] = state.piece_board(self_pawn_id + i).to_ullong();
+			enemy[i] = state.piece_board(enemy_pawn_id + i).to_ullong();
+			enemy_board |= enemy[i];
+		}
+
+		//moves and captures of all pieces except cannon, a piece captures the pieces whose rank is not higher,
+		//but king can not capture pawn and pawn can capture king.
+		const uint64_t empty_board = state.piece_board(PIECE_EMPTY).to_ullong();
+		uint64_t captureable_board = enemy[0];
+		for (size_t i = 0; i < 7; i++)
+		{
+			if (i != 0)
+			{
+				captureable_board |= enemy[i];
+			}
+			if (i == 1 || self[i] == 0)
+			{
+				continue;
+			}
+			uint64_t target_board = empty_board | captureable_board;
+			if (i == 0)
+			{
+				target_board |= enemy[6];
+			}
+			else if (i == 6)
+			{
+				target_board &= ~enemy[0];
+			}
+			if ((AdjacentBoard(self[i]) & target_board) != 0)
+			{
+				return true;
+			}
+		}
+
+		//cannon flies, the same as ActionGenerator.
+		const uint64_t exist_board = ~empty_board & 0xFFFFFFFF;
+		uint64_t cannon_board = self[1];
+		while (cannon_board != 0)
+		{
+			const size_t i = gadt::stl::TrailingZeroCount(cannon_board);
+			cannon_board &= cannon_board - 1;
+			if ((CannonFlyBoard(i, exist_board) & enemy_board) != 0)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
 }
\ No newline at end of file
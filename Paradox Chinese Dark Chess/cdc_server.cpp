@@ -0,0 +1,295 @@
+#include "cdc_server.h"
+
+#ifdef __GADT_GNUC
+	#include <sys/socket.h>
+	#include <sys/un.h>
+#endif
+
+namespace chinese_dark_chess
+{
+	namespace server
+	{
+		RequestPool::RequestPool(json_interface::AIService & service, size_t worker_count, size_t capacity) :
+			_service(service),
+			_workers(),
+			_tasks(),
+			_free_tasks(),
+			_queue(std::max<size_t>(1, capacity), nullptr),
+			_queue_head(0),
+			_queue_size(0),
+			_stopped(false)
+		{
+			for (size_t i = 0; i < std::max<size_t>(1, worker_count); i++)
+			{
+				_workers.push_back(std::thread([this]() { WorkerLoop(); }));
+			}
+		}
+
+		RequestPool::~RequestPool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				_stopped = true;
+			}
+			_not_empty.notify_all();
+			for (auto& worker : _workers)
+			{
+				worker.join();
+			}
+		}
+
+		void RequestPool::WorkerLoop()
+		{
+			Engine engine(_service.setting());
+			for (;;)
+			{
+				Task* task;
+				{
+					std::unique_lock<std::mutex> lock(_mutex);
+					_not_empty.wait(lock, [this]() { return _queue_size != 0 || _stopped; });
+					if (_queue_size == 0)
+					{
+						return;
+					}
+					task = _queue[_queue_head];
+					_queue_head = (_queue_head + 1) % _queue.size();
+					_queue_size--;
+				}
+				_not_full.notify_one();
+				_service.Respond(task->request, engine, task->response);
+				{
+					std::lock_guard<std::mutex> lock(_mutex);
+					task->finished = true;
+				}
+				_finished.notify_all();
+			}
+		}
+
+		RequestPool::Task* RequestPool::Submit(std::string& request)
+		{
+			Task* task;
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_not_full.wait(lock, [this]() { return _queue_size < _queue.size(); });
+				if (_free_tasks.empty())
+				{
+					_tasks.push_back(std::unique_ptr<Task>(new Task()));
+					_free_tasks.push_back(_tasks.back().get());
+				}
+				task = _free_tasks.back();
+				_free_tasks.pop_back();
+				task->request.swap(request);
+				task->finished = false;
+				_queue[(_queue_head + _queue_size) % _queue.size()] = task;
+				_queue_size++;
+			}
+			_not_empty.notify_one();
+			return task;
+		}
+
+		const std::string& RequestPool::Wait(Task* task)
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_finished.wait(lock, [task]() { return task->finished; });
+			return task->response;
+		}
+
+		void RequestPool::Release(Task* task)
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_free_tasks.push_back(task);
+		}
+
+		//serve lines by the pool, responses are written in the order of requests.
+		//the number of unwritten responses is bounded by the queue and workers of the pool.
+		template<typename ReadLineFunc, typename WriteLineFunc>
+		static void ServeLines(RequestPool& pool, ReadLineFunc ReadLine, WriteLineFunc WriteLine)
+		{
+			//ring buffer of tasks whose responses are not written.
+			std::vector<RequestPool::Task*> pending(pool.capacity() + pool.worker_count(), nullptr);
+			size_t pending_head = 0;
+			size_t pending_size = 0;
+			std::mutex mutex;
+			std::condition_variable changed;
+			bool finished = false;
+
+			std::thread writer([&]() {
+				bool writable = true;
+				for (;;)
+				{
+					RequestPool::Task* task;
+					{
+						std::unique_lock<std::mutex> lock(mutex);
+						changed.wait(lock, [&]() { return pending_size != 0 || finished; });
+						if (pending_size == 0)
+						{
+							return;
+						}
+						task = pending[pending_head];
+					}
+					const std::string& response = pool.Wait(task);
+					writable = writable && WriteLine(response);
+					pool.Release(task);
+					{
+						std::lock_guard<std::mutex> lock(mutex);
+						pending_head = (pending_head + 1) % pending.size();
+						pending_size--;
+					}
+					changed.notify_all();
+				}
+			});
+
+			std::string line;
+			while (ReadLine(line))
+			{
+				if (!line.empty() && line.back() == '\r')
+				{
+					line.pop_back();
+				}
+				if (line.empty())
+				{
+					continue;
+				}
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					changed.wait(lock, [&]() { return pending_size < pending.size(); });
+				}
+				RequestPool::Task* task = pool.Submit(line);
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					pending[(pending_head + pending_size) % pending.size()] = task;
+					pending_size++;
+				}
+				changed.notify_all();
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				finished = true;
+			}
+			changed.notify_all();
+			writer.join();
+		}
+
+		void ServeStream(RequestPool & pool, std::istream & is, std::ostream & os)
+		{
+			ServeLines(pool,
+				[&](std::string& line)->bool { return bool(std::getline(is, line)); },
+				[&](const std::string& line)->bool {
+					os << line << '\n';
+					os.flush();
+					return bool(os);
+				}
+			);
+		}
+
+#ifdef __GADT_GNUC
+		//write all bytes to the socket, return false if the connection is closed.
+		static bool WriteAll(int fd, const char* data, size_t size)
+		{
+			size_t written = 0;
+			while (written < size)
+			{
+				//a closed connection should not raise SIGPIPE.
+#ifdef MSG_NOSIGNAL
+				const ssize_t n = send(fd, data + written, size - written, MSG_NOSIGNAL);
+#else
+				const ssize_t n = write(fd, data + written, size - written);
+#endif
+				if (n < 0 && errno == EINTR)
+				{
+					continue;
+				}
+				if (n <= 0)
+				{
+					return false;
+				}
+				written += size_t(n);
+			}
+			return true;
+		}
+
+		//serve requests of a connection until it is closed.
+		static void ServeConnection(RequestPool& pool, int fd)
+		{
+			std::string buffer;
+			size_t begin = 0;
+			auto ReadLine = [&](std::string& line)->bool {
+				for (;;)
+				{
+					const size_t end = buffer.find('\n', begin);
+					if (end != std::string::npos)
+					{
+						line.assign(buffer, begin, end - begin);
+						begin = end + 1;
+						return true;
+					}
+					buffer.erase(0, begin);
+					begin = 0;
+
+					char chunk[4096];
+					const ssize_t n = read(fd, chunk, sizeof(chunk));
+					if (n < 0 && errno == EINTR)
+					{
+						continue;
+					}
+					if (n <= 0)
+					{
+						return false;
+					}
+					buffer.append(chunk, size_t(n));
+				}
+			};
+			ServeLines(pool, ReadLine, [&](const std::string& line)->bool {
+				return WriteAll(fd, line.data(), line.size()) && WriteAll(fd, "\n", 1);
+			});
+			close(fd);
+		}
+
+		bool ServeSocket(RequestPool & pool, const std::string & path)
+		{
+			sockaddr_un address;
+			memset(&address, 0, sizeof(address));
+			if (path.size() >= sizeof(address.sun_path))
+			{
+				return false;
+			}
+			address.sun_family = AF_UNIX;
+			memcpy(address.sun_path, path.c_str(), path.size());
+
+			const int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+			if (listen_fd < 0)
+			{
+				return false;
+			}
+			unlink(path.c_str());
+			if (bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(listen_fd, SOMAXCONN) < 0)
+			{
+				close(listen_fd);
+				return false;
+			}
+			for (;;)
+			{
+				const int fd = accept(listen_fd, nullptr, nullptr);
+				if (fd < 0)
+				{
+					if (errno == EINTR)
+					{
+						continue;
+					}
+					break;
+				}
+				std::thread([&pool, fd]() { ServeConnection(pool, fd); }).detach();
+			}
+			close(listen_fd);
+			unlink(path.c_str());
+			return true;
+		}
+#else
+		bool ServeSocket(RequestPool & pool, const std::string & path)
+		{
+			return false;
+		}
+#endif
+	}
+}
@@ -0,0 +1,93 @@
+#include "cdc_interface.h"
+#include <condition_variable>
+#include <memory>
+
+#pragma once
+
+namespace chinese_dark_chess
+{
+	namespace server
+	{
+		/*
+		* RequestPool responds requests by a fixed number of workers.
+		*
+		* each worker thread owns an engine, so its node pool, move stacks and random generator are never shared,
+		* and the memory of each request is bounded by the engine setting. requests are dispatched by a bounded queue,
+		* Submit blocks while the queue is full. queued requests are finished before the pool is destroyed.
+		* tasks and their request and response buffers are recycled by Release, so the pool itself does not allocate
+		* once the number of tasks in flight has been reached before.
+		*/
+		class RequestPool
+		{
+		public:
+			//a request and its response, which is got by Submit and given back by Release.
+			struct Task
+			{
+				std::string	request;
+				std::string	response;
+				bool		finished;
+			};
+
+		private:
+			json_interface::AIService&			_service;
+			std::vector<std::thread>			_workers;
+			std::vector<std::unique_ptr<Task>>	_tasks;			//all tasks created by the pool.
+			std::vector<Task*>					_free_tasks;	//tasks that could be reused.
+			std::vector<Task*>					_queue;			//ring buffer of queued tasks.
+			size_t								_queue_head;
+			size_t								_queue_size;
+			std::mutex							_mutex;
+			std::condition_variable				_not_empty;
+			std::condition_variable				_not_full;
+			std::condition_variable				_finished;
+			bool								_stopped;
+
+		private:
+			//take requests from the queue and respond them by the engine of the worker.
+			void WorkerLoop();
+
+		public:
+			RequestPool(json_interface::AIService& service, size_t worker_count, size_t capacity);
+
+			RequestPool(const RequestPool&) = delete;
+
+			~RequestPool();
+
+			//add a request to the queue, which blocks while the queue is full.
+			//the request is swapped with the buffer of the task, so the string keeps a reusable buffer.
+			Task* Submit(std::string& request);
+
+			//wait until the task is finished and get its response, which is valid until the task is released.
+			const std::string& Wait(Task* task);
+
+			//give back the task after its response is used.
+			void Release(Task* task);
+
+			//get the number of workers.
+			inline size_t worker_count() const
+			{
+				return _workers.size();
+			}
+
+			//get the max number of queued requests.
+			inline size_t capacity() const
+			{
+				return _queue.size();
+			}
+		};
+
+		/*
+		* server mode answers newline-delimited json requests by a request pool.
+		*
+		* each line of input is a request, which is the same json as the input of ChineseDarkChessAI,
+		* and each response is written as one line in the order of requests. empty lines are ignored.
+		*/
+
+		//serve requests from the input stream until it ends.
+		void ServeStream(RequestPool& pool, std::istream& is, std::ostream& os);
+
+		//serve requests from clients of the unix domain socket at the path, each client is served by its own thread.
+		//return false if the socket can not be created, which is always false on the platform without unix domain socket.
+		bool ServeSocket(RequestPool& pool, const std::string& path);
+	}
+}
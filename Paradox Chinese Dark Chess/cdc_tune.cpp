@@ -0,0 +1,454 @@
+#include "cdc_tune.h"
+
+namespace chinese_dark_chess
+{
+	namespace tune
+	{
+		PositionRecord EncodeState(const State & state, float target)
+		{
+			PositionRecord record;
+			memset(&record, 0, sizeof(record));
+			for (size_t i = 0; i < g_CDC_MAX_LENGTH; i++)
+			{
+				PieceType piece = state.piece_at(i);
+				if (piece == PIECE_EMPTY)
+				{
+					piece = PIECE_UNDECIDED;
+				}
+				record.board[i / 2] |= uint8_t(piece) << ((i % 2) * 4);
+			}
+			record.hidden = state.hidden_pieces().to_ullong();
+			record.next_player = state.next_player();
+			record.target = target;
+			return record;
+		}
+
+		State DecodeState(const PositionRecord & record)
+		{
+			std::vector<std::vector<PieceType>> data(g_CDC_BOARD_WIDTH, std::vector<PieceType>(g_CDC_BOARD_HEIGHT, PIECE_EMPTY));
+			for (size_t i = 0; i < g_CDC_MAX_LENGTH; i++)
+			{
+				PieceType piece = PieceType((record.board[i / 2] >> ((i % 2) * 4)) & 0xF);
+				if (piece == PIECE_UNDECIDED)
+				{
+					piece = PIECE_EMPTY;
+				}
+				data[i % g_CDC_BOARD_WIDTH][i / g_CDC_BOARD_WIDTH] = piece;
+			}
+			return State(data, HiddenPiece(record.hidden), PlayerIndex(record.next_player));
+		}
+
+		float WinnerToTarget(int8_t winner)
+		{
+			if (winner == PLAYER_RED)
+			{
+				return 1;
+			}
+			if (winner == PLAYER_BLACK)
+			{
+				return 0;
+			}
+			return 0.5f;
+		}
+
+		bool PositionCache::load(const std::string & path)
+		{
+			std::ifstream ifs(path, std::ios::binary);
+			if (!ifs)
+			{
+				return false;
+			}
+			char magic[4];
+			uint32_t version = 0;
+			uint64_t count = 0;
+			ifs.read(magic, sizeof(magic));
+			ifs.read(reinterpret_cast<char*>(&version), sizeof(version));
+			ifs.read(reinterpret_cast<char*>(&count), sizeof(count));
+			if (!ifs || memcmp(magic, g_POSITION_CACHE_MAGIC, sizeof(magic)) != 0 || version != g_POSITION_CACHE_VERSION)
+			{
+				return false;
+			}
+
+			//the count is checked by the size of file before any memory is allocated.
+			const std::streamoff header_end = ifs.tellg();
+			ifs.seekg(0, std::ios::end);
+			const std::streamoff file_end = ifs.tellg();
+			ifs.seekg(header_end);
+			if (!ifs || header_end < 0 || file_end < header_end || count > uint64_t(file_end - header_end) / sizeof(PositionRecord))
+			{
+				return false;
+			}
+			const size_t old_size = _records.size();
+			_records.resize(old_size + size_t(count));
+			ifs.read(reinterpret_cast<char*>(_records.data() + old_size), std::streamsize(count * sizeof(PositionRecord)));
+			if (!ifs)
+			{
+				_records.resize(old_size);
+				return false;
+			}
+			return true;
+		}
+
+		bool PositionCache::load_if_exist(const std::string & path)
+		{
+			return !gadt::file::FileExist(path) || load(path);
+		}
+
+		bool PositionCache::save(const std::string & path) const
+		{
+			std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+			if (!ofs)
+			{
+				return false;
+			}
+			const uint32_t version = g_POSITION_CACHE_VERSION;
+			const uint64_t count = _records.size();
+			ofs.write(g_POSITION_CACHE_MAGIC, 4);
+			ofs.write(reinterpret_cast<const char*>(&version), sizeof(version));
+			ofs.write(reinterpret_cast<const char*>(&count), sizeof(count));
+			ofs.write(reinterpret_cast<const char*>(_records.data()), std::streamsize(count * sizeof(PositionRecord)));
+			return bool(ofs);
+		}
+
+		float Playout(const State & state)
+		{
+			State temp = state;
+			for (size_t i = 0; i < g_PLAYOUT_MAX_LENGTH; i++)
+			{
+				const int8_t winner = engine_func::DetemineWinner(temp);
+				if (winner != 0)
+				{
+					return WinnerToTarget(winner);
+				}
+				if (temp.exist_undecided_piece() || temp.remove_hidden_flag())
+				{
+					ActionGenerator generator(temp);
+					temp.to_next(generator.random_action());
+					continue;
+				}
+
+				ActionGenerator captures(temp, CAPTURE_ONLY_POLICY);
+				if (captures.size() > 0)
+				{
+					size_t best = 0;
+					for (size_t n = 1; n < captures.size(); n++)
+					{
+						if (MoveOrdering::MvvLva(temp, captures[n]) > MoveOrdering::MvvLva(temp, captures[best]))
+						{
+							best = n;
+						}
+					}
+					temp.to_next(captures[best]);
+				}
+				else
+				{
+					ActionGenerator generator(temp);
+					temp.to_next(generator.random_action());
+				}
+			}
+			return 0.5f;
+		}
+
+		size_t ImportRequestLog(const std::string & path, size_t playout_count, PositionCache & cache, ErrorLog & err)
+		{
+			constexpr const char* request_key = "\"request\":";
+			std::ifstream ifs(path);
+			if (!ifs)
+			{
+				err.add("failed to open " + path);
+				return 0;
+			}
+
+			size_t added = 0;
+			size_t line_number = 0;
+			std::string line;
+			while (std::getline(ifs, line))
+			{
+				line_number++;
+				const size_t begin = line.find(request_key);
+				if (begin == std::string::npos)
+				{
+					continue;
+				}
+
+				//the request is followed by a comma.
+				std::string json_str = line.substr(begin + strlen(request_key));
+				while (!json_str.empty() && (json_str.back() == ',' || isspace((unsigned char)json_str.back())))
+				{
+					json_str.pop_back();
+				}
+
+				ErrorLog state_err;
+				State state = json_interface::ParseState(json_str, state_err);
+				if (!state_err.is_empty())
+				{
+					err.add(path + ":" + std::to_string(line_number) + " illegal request. " + state_err.output());
+					continue;
+				}
+				if (engine_func::DetemineWinner(state) != 0)
+				{
+					continue;
+				}
+
+				double target = 0;
+				for (size_t i = 0; i < playout_count; i++)
+				{
+					target += Playout(state);
+				}
+				cache.add(state, float(playout_count > 0 ? target / playout_count : 0.5));
+				added++;
+			}
+			return added;
+		}
+
+		size_t SelfPlay(size_t game_count, const EngineSetting & setting, PositionCache & cache)
+		{
+			size_t added = 0;
+			for (size_t game = 0; game < game_count; game++)
+			{
+				Engine red_engine(setting);
+				Engine black_engine(setting);
+				std::vector<State> positions;
+				State state;
+				int8_t winner = 0;
+				for (size_t ply = 0; ply < g_PLAYOUT_MAX_LENGTH; ply++)
+				{
+					winner = engine_func::DetemineWinner(state);
+					if (winner != 0)
+					{
+						break;
+					}
+					if (state.exist_undecided_piece() || state.remove_hidden_flag())
+					{
+						ActionGenerator generator(state);
+						state.to_next(generator.random_action());
+						continue;
+					}
+					positions.push_back(state);
+					Engine& engine = state.next_player() == PLAYER_RED ? red_engine : black_engine;
+					state.to_next(engine.DoSearch(state));
+				}
+
+				const float target = WinnerToTarget(winner);
+				for (const State& position : positions)
+				{
+					cache.add(position, target);
+				}
+				added += positions.size();
+			}
+			return added;
+		}
+
+		static_assert(sizeof(EvalWeight::piece_value) / sizeof(double) == g_TUNE_RANK_COUNT, "piece values should match tuned ranks.");
+
+		std::vector<double> WeightToParams(const EvalWeight & weight)
+		{
+			std::vector<double> params(weight.piece_value, weight.piece_value + g_TUNE_RANK_COUNT);
+			params.reserve(g_TUNE_PARAM_COUNT);
+			params.push_back(weight.prey_scale);
+			params.push_back(weight.safety_scale);
+			params.push_back(weight.hidden_scale);
+			params.push_back(weight.mobility);
+			params.push_back(weight.threat);
+			return params;
+		}
+
+		EvalWeight ParamsToWeight(const std::vector<double>& params, const EvalWeight & base)
+		{
+			GADT_CHECK_WARNING(g_CDC_DEFINE_CHECK, params.size() != g_TUNE_PARAM_COUNT, "wrong number of tuned weights");
+			EvalWeight weight = base;
+			for (size_t rank = 0; rank < g_TUNE_RANK_COUNT; rank++)
+			{
+				weight.piece_value[rank] = params[rank];
+			}
+			weight.prey_scale = params[g_TUNE_RANK_COUNT];
+			weight.safety_scale = params[g_TUNE_RANK_COUNT + 1];
+			weight.hidden_scale = params[g_TUNE_RANK_COUNT + 2];
+			weight.mobility = params[g_TUNE_RANK_COUNT + 3];
+			weight.threat = params[g_TUNE_RANK_COUNT + 4];
+			return weight;
+		}
+
+		std::string WeightToString(const EvalWeight & weight)
+		{
+			std::stringstream ss;
+			ss << "piece_value{ ";
+			for (size_t rank = 0; rank < g_TUNE_RANK_COUNT; rank++)
+			{
+				ss << weight.piece_value[rank] << (rank + 1 < g_TUNE_RANK_COUNT ? ", " : " },\n");
+			}
+			ss << "prey_scale(" << weight.prey_scale << "),\n";
+			ss << "safety_scale(" << weight.safety_scale << "),\n";
+			ss << "hidden_scale(" << weight.hidden_scale << "),\n";
+			ss << "mobility(" << weight.mobility << "),\n";
+			ss << "threat(" << weight.threat << "),\n";
+			ss << "logistic_scale(" << weight.logistic_scale << ")\n";
+			return ss.str();
+		}
+
+		std::vector<double> EvalTuner::Losses(const std::vector<EvalWeight>& weights) const
+		{
+			std::vector<std::unique_ptr<MaterialTable>> tables;
+			for (const EvalWeight& weight : weights)
+			{
+				tables.emplace_back(new MaterialTable(weight));
+			}
+
+			const size_t thread_count = std::max<size_t>(1, std::min(_setting.thread_count, _cache.size()));
+			std::vector<std::vector<double>> sums(thread_count, std::vector<double>(weights.size(), 0));
+			auto Work = [&](size_t index) {
+				std::vector<double>& sum = sums[index];
+				const size_t begin = _cache.size() * index / thread_count;
+				const size_t end = _cache.size() * (index + 1) / thread_count;
+				for (size_t i = begin; i < end; i++)
+				{
+					const PositionRecord& record = _cache.record(i);
+					const State state = DecodeState(record);
+					for (size_t n = 0; n < weights.size(); n++)
+					{
+						const double error = record.target - StateEval(state, weights[n], *tables[n]).win_probability(PLAYER_RED);
+						sum[n] += error * error;
+					}
+				}
+			};
+
+			std::vector<std::thread> threads;
+			for (size_t i = 1; i < thread_count; i++)
+			{
+				threads.emplace_back(Work, i);
+			}
+			Work(0);
+			for (auto& thread : threads)
+			{
+				thread.join();
+			}
+
+			std::vector<double> losses(weights.size(), 0);
+			for (size_t n = 0; n < weights.size(); n++)
+			{
+				for (size_t i = 0; i < thread_count; i++)
+				{
+					losses[n] += sums[i][n];
+				}
+				losses[n] /= std::max<size_t>(1, _cache.size());
+			}
+			return losses;
+		}
+
+		double EvalTuner::Loss(const EvalWeight & weight) const
+		{
+			return Losses({ weight }).front();
+		}
+
+		EvalWeight EvalTuner::FitLogisticScale(const EvalWeight & weight) const
+		{
+			const double ratio = (std::sqrt(5.0) - 1) / 2;
+			double low = 0.5;
+			double high = 100;
+			EvalWeight temp = weight;
+			auto LossOfScale = [&](double scale) {
+				temp.logistic_scale = scale;
+				return Loss(temp);
+			};
+			double left = high - ratio * (high - low);
+			double right = low + ratio * (high - low);
+			double left_loss = LossOfScale(left);
+			double right_loss = LossOfScale(right);
+			for (size_t i = 0; i < 30; i++)
+			{
+				if (left_loss < right_loss)
+				{
+					high = right;
+					right = left;
+					right_loss = left_loss;
+					left = high - ratio * (high - low);
+					left_loss = LossOfScale(left);
+				}
+				else
+				{
+					low = left;
+					left = right;
+					left_loss = right_loss;
+					right = low + ratio * (high - low);
+					right_loss = LossOfScale(right);
+				}
+			}
+			temp.logistic_scale = (low + high) / 2;
+			return temp;
+		}
+
+		EvalWeight EvalTuner::Tune(const EvalWeight & weight, bool print) const
+		{
+			EvalWeight base = FitLogisticScale(weight);
+			std::vector<double> params = WeightToParams(base);
+			std::vector<double> steps(params.size());
+			std::vector<double> prev_gradient(params.size(), 0);
+			for (size_t i = 0; i < params.size(); i++)
+			{
+				steps[i] = _setting.init_step * std::max(1.0, std::abs(params[i]));
+			}
+
+			EvalWeight best_weight = base;
+			double best_loss = std::numeric_limits<double>::infinity();
+			for (size_t iteration = 0; iteration < _setting.max_iteration; iteration++)
+			{
+				//the first weights is the current one, followed by the pairs of perturbed weights.
+				std::vector<double> deltas(params.size());
+				std::vector<EvalWeight> weights = { ParamsToWeight(params, base) };
+				for (size_t i = 0; i < params.size(); i++)
+				{
+					deltas[i] = _setting.gradient_step * std::max(1.0, std::abs(params[i]));
+					std::vector<double> plus = params;
+					std::vector<double> minus = params;
+					plus[i] += deltas[i];
+					minus[i] -= deltas[i];
+					weights.push_back(ParamsToWeight(plus, base));
+					weights.push_back(ParamsToWeight(minus, base));
+				}
+				const std::vector<double> losses = Losses(weights);
+				if (losses[0] < best_loss)
+				{
+					best_loss = losses[0];
+					best_weight = weights[0];
+				}
+				if (print)
+				{
+					std::cout << "iteration " << iteration << " loss = " << losses[0] << " best = " << best_loss << std::endl;
+				}
+
+				//RPROP, steps grow while the sign of gradient is kept and shrink once it changes.
+				bool converged = true;
+				for (size_t i = 0; i < params.size(); i++)
+				{
+					const double gradient = (losses[1 + i * 2] - losses[2 + i * 2]) / (2 * deltas[i]);
+					if (gradient * prev_gradient[i] > 0)
+					{
+						steps[i] *= 1.2;
+					}
+					else if (gradient * prev_gradient[i] < 0)
+					{
+						steps[i] *= 0.5;
+					}
+					prev_gradient[i] = gradient;
+					if (gradient > 0)
+					{
+						params[i] = std::max(0.0, params[i] - steps[i]);
+					}
+					else if (gradient < 0)
+					{
+						params[i] += steps[i];
+					}
+					if (steps[i] >= _setting.min_step * std::max(1.0, std::abs(params[i])))
+					{
+						converged = false;
+					}
+				}
+				if (converged)
+				{
+					break;
+				}
+			}
+			return best_weight;
+		}
+	}
+}
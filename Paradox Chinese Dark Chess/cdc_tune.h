@@ -0,0 +1,158 @@
+#include "cdc_engine.h"
+#include "cdc_interface.h"
+
+#pragma once
+
+namespace chinese_dark_chess
+{
+	namespace tune
+	{
+		constexpr const char*	g_POSITION_CACHE_MAGIC = "CDCP";	//magic of binary position cache file.
+		constexpr const uint32_t g_POSITION_CACHE_VERSION = 1;		//version of binary position cache file.
+		constexpr const size_t	g_TUNE_RANK_COUNT = 7;				//number of piece ranks, whose values are the first tuned weights.
+		constexpr const size_t	g_TUNE_PARAM_COUNT = g_TUNE_RANK_COUNT + 5;	//number of tuned weights, logistic scale is fitted alone.
+		constexpr const size_t	g_PLAYOUT_MAX_LENGTH = 1000;		//max length of a playout that labels a position.
+
+		/*
+		* PositionRecord is a compact record of a deterministic position and its result.
+		*
+		* each location is saved as 4 bits, empty location is saved as PIECE_UNDECIDED since undecided pieces are never recorded.
+		*/
+		struct PositionRecord
+		{
+			uint8_t		board[g_CDC_MAX_LENGTH / 2];	//pieces of locations, two locations per byte.
+			uint64_t	hidden;							//raw hidden pieces.
+			int8_t		next_player;					//next player of the position.
+			uint8_t		reserved[3];
+			float		target;							//score of red player, 1 is win, 0.5 is draw and 0 is loss.
+		};
+
+		static_assert(sizeof(PositionRecord) == 32, "PositionRecord should be 32 bytes.");
+
+		//encode a state without chance to record.
+		PositionRecord EncodeState(const State& state, float target);
+
+		//decode record to state.
+		State DecodeState(const PositionRecord& record);
+
+		//get the score of red player by the winner, which is got by engine_func::DetemineWinner.
+		float WinnerToTarget(int8_t winner);
+
+		/*
+		* PositionCache is a list of position records that could be saved as binary file.
+		*
+		* file format: magic(4 bytes), version(uint32), count(uint64), records.
+		*/
+		class PositionCache
+		{
+		private:
+			std::vector<PositionRecord> _records;
+
+		public:
+			PositionCache() :
+				_records()
+			{
+			}
+
+			//load records from file and append them to the cache, return false if the file is illegal.
+			bool load(const std::string& path);
+
+			//load records from file if it exists, return false if the file exists but is illegal.
+			bool load_if_exist(const std::string& path);
+
+			//save all records to file, return false if the file can not be written.
+			bool save(const std::string& path) const;
+
+			//add a record of the state.
+			inline void add(const State& state, float target)
+			{
+				_records.push_back(EncodeState(state, target));
+			}
+
+			//get record by index.
+			inline const PositionRecord& record(size_t index) const
+			{
+				return _records[index];
+			}
+
+			//get the number of records.
+			inline size_t size() const
+			{
+				return _records.size();
+			}
+		};
+
+		//play the state to the end, captures are prior to be selected by MVV-LVA and other actions are selected by random.
+		float Playout(const State& state);
+
+		//parse the request log written by ChineseDarkChessAI, each position is labeled by the average result of playouts.
+		//return the number of added positions.
+		size_t ImportRequestLog(const std::string& path, size_t playout_count, PositionCache& cache, ErrorLog& err);
+
+		//play games between engines and add all positions that are labeled by the game result.
+		//return the number of added positions.
+		size_t SelfPlay(size_t game_count, const EngineSetting& setting, PositionCache& cache);
+
+		//get tuned weights as vector.
+		std::vector<double> WeightToParams(const EvalWeight& weight);
+
+		//set tuned weights by vector, other weights are copied from the base weights.
+		EvalWeight ParamsToWeight(const std::vector<double>& params, const EvalWeight& base);
+
+		//get weights as c++ code that could be pasted to EvalWeight.
+		std::string WeightToString(const EvalWeight& weight);
+
+		//setting of tuner.
+		struct TuneSetting
+		{
+			size_t	thread_count;		//number of threads that compute loss and gradient.
+			size_t	max_iteration;		//max number of gradient steps.
+			double	init_step;			//initial step of each weight, scaled by the magnitude of the weight.
+			double	gradient_step;		//step of central difference, scaled by the magnitude of the weight.
+			double	min_step;			//tuning stops if all steps are smaller than it.
+
+			TuneSetting() :
+				thread_count(std::max<size_t>(1, std::thread::hardware_concurrency())),
+				max_iteration(100),
+				init_step(0.05),
+				gradient_step(0.01),
+				min_step(1e-4)
+			{
+			}
+		};
+
+		/*
+		* EvalTuner fits the weights of StateEval by logistic regression, which is known as Texel tuning.
+		*
+		* the loss is the mean squared error between the target of positions and the win probability of red player.
+		* the logistic scale is fitted first, then weights are tuned by RPROP with gradients of central differences.
+		* positions are split among threads, each thread decodes a position once and evaluates it with all perturbed weights.
+		*/
+		class EvalTuner
+		{
+		private:
+			const PositionCache&	_cache;
+			TuneSetting				_setting;
+
+		private:
+			//get the loss of each weights, the loss is computed by threads.
+			std::vector<double> Losses(const std::vector<EvalWeight>& weights) const;
+
+		public:
+			EvalTuner(const PositionCache& cache, TuneSetting setting = TuneSetting()) :
+				_cache(cache),
+				_setting(setting)
+			{
+			}
+
+			//get the loss of the weights.
+			double Loss(const EvalWeight& weight) const;
+
+			//fit the logistic scale of weights by golden section search.
+			EvalWeight FitLogisticScale(const EvalWeight& weight) const;
+
+			//tune the weights, the progress is printed if print is true.
+			EvalWeight Tune(const EvalWeight& weight, bool print = true) const;
+		};
+	}
+}
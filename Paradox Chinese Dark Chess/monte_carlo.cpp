@@ -18,6 +18,11 @@ namespace chinese_dark_chess
 	}
 
 	const Action & MonteCarlo::DoMonteCarlo(size_t simulation_times) const
+	{
+		return DoMonteCarlo(simulation_times, std::numeric_limits<double>::max());
+	}
+
+	const Action & MonteCarlo::DoMonteCarlo(size_t simulation_times, double timeout) const
 	{
 		//constexpr bool enable_log = false;
 
@@ -25,29 +30,44 @@ namespace chinese_dark_chess
 		if (_actions.size() == 1)
 			return _actions[0];
 
-		//excute simulations for each action.
-		const size_t single_action_simu_time = 1 + (simulation_times / _actions.size());
-		size_t best_count = 0;
-		size_t best_index = 0;
+		//the state after each action.
+		std::vector<State> child_states;
+		child_states.reserve(_actions.size());
 		for (size_t i = 0; i < _actions.size(); i++)
 		{
-			size_t count = 1;
-			State new_state = _state;
-			new_state.to_next(_actions.action(i));
-			for (size_t n = 0; n < single_action_simu_time; n++)
+			child_states.push_back(_state);
+			child_states.back().to_next(_actions.action(i));
+		}
+
+		//excute simulations for each action in rounds, so that all actions get the same simulation times when timeout.
+		const size_t single_action_simu_time = 1 + (simulation_times / _actions.size());
+		std::vector<size_t> win_count(_actions.size(), 1);
+		gadt::timer::Deadline deadline(timeout);
+		size_t round = 0;
+		for (; round < single_action_simu_time; round++)
+		{
+			if (deadline.poll_timeout())
+				break;
+
+			for (size_t i = 0; i < _actions.size(); i++)
 			{
-				Result result = Simulation(new_state);
+				Result result = Simulation(child_states[i]);
 				if ((int8_t)result == (int8_t)_state.next_player())
-					count++;
-			}
-			if (count > best_count)
-			{
-				best_index = 1;
-				best_count = count;
+					win_count[i]++;
 			}
 		}
 
 		//select best win count action.
+		size_t best_count = 0;
+		size_t best_index = 0;
+		for (size_t i = 0; i < _actions.size(); i++)
+		{
+			if (win_count[i] > best_count)
+			{
+				best_index = i;
+				best_count = win_count[i];
+			}
+		}
 		return _actions[best_index];
 	}
 }
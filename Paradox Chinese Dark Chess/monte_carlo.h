@@ -22,8 +22,12 @@ namespace chinese_dark_chess
 		{
 		}
 
+		//excute flat monte carlo with appointed simulation times.
 		const Action& DoMonteCarlo(size_t simulation_times) const;
 
+		//excute flat monte carlo until simulation times run out or timeout (seconds).
+		const Action& DoMonteCarlo(size_t simulation_times, double timeout) const;
+
 		/*const Action& DoFlatMonteCarlo(size_t simulation_times) const
 		{
 
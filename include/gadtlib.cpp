@@ -87,8 +87,16 @@ namespace gadt
 			std::cout << std::endl << std::endl;
 		}
 
+		//warnings are written to stderr without pause if it is true.
+		static std::atomic<bool> g_quiet_warning(false);
+
 		void WarningCheck(bool condition, std::string reason, std::string file, int line, std::string function)
 		{
+			if (condition && g_quiet_warning.load(std::memory_order_relaxed))
+			{
+				std::cerr << ">> WARNING: " + reason + " [" + file + ":" + IntergerToString(line) + " " + function + "]\n";
+				return;
+			}
 			if (condition)
 			{
 				std::cout << std::endl << std::endl;
@@ -105,6 +113,11 @@ namespace gadt
 			}
 		}
 
+		void SetQuietWarning(bool quiet)
+		{
+			g_quiet_warning.store(quiet, std::memory_order_relaxed);
+		}
+
 		void SystemPause()
 		{
 #ifdef __GADT_GNUC
@@ -128,19 +141,27 @@ namespace gadt
 	{
 		std::string TimeString(std::string format)
 		{
-			time_t t = time(NULL);
 			char buf[128] = { 0 };
-#ifdef __GADT_MSVC
+			TimeString(buf, 64, format.c_str());
+			return std::string(buf);
+		}
+
+		//write time string to the buffer without allocation, return the length of the string.
+		size_t TimeString(char* buffer, size_t size, const char* format)
+		{
+			time_t t = time(NULL);
 			tm local;
+#ifdef __GADT_MSVC
 			localtime_s(&local, &t);
-			strftime(buf, 64, format.c_str(), &local);
-			return std::string(buf);
 #else
-			tm* local;
-			local = localtime(&t);
-			strftime(buf, 64, format.c_str(), local);
-			return std::string(buf);
+			localtime_r(&t, &local);
 #endif
+			const size_t length = strftime(buffer, size, format, &local);
+			if (length == 0 && size > 0)
+			{
+				buffer[0] = '\0';
+			}
+			return length;
 		}
 
 		clock_t GetClock()
@@ -163,13 +184,39 @@ namespace gadt
 			strftime(buf, 64, format.c_str(), &local);
 			return std::string(buf);
 #else
-			tm* local;
-			local = localtime(&t);
-			strftime(buf, 64, format.c_str(), local);
+			tm local;
+			localtime_r(&t, &local);
+			strftime(buf, 64, format.c_str(), &local);
 			return std::string(buf);
 #endif
 		}
 
+		bool Deadline::check_clock()
+		{
+			Clock::time_point now = Clock::now();
+			double elapsed = std::chrono::duration<double>(now - _last_check).count();
+			_last_check = now;
+			if (std::chrono::duration<double>(now - _start).count() >= _timeout)
+			{
+				_expired = true;
+				return true;
+			}
+
+			//adapt interval so that the next reading happens after about one poll period,
+			//the interval grows at most twice each time to avoid overshooting the deadline.
+			size_t interval = _poll_interval * 2;
+			if (elapsed > 0)
+			{
+				double expected = static_cast<double>(_poll_interval) * _poll_period / elapsed;
+				if (expected < static_cast<double>(interval))
+				{
+					interval = expected < 1 ? 1 : static_cast<size_t>(expected);
+				}
+			}
+			_poll_interval = interval < _max_poll_interval ? interval : _max_poll_interval;
+			_countdown = _poll_interval;
+			return false;
+		}
 	}
 
 	namespace file
@@ -183,6 +230,15 @@ namespace gadt
 #endif
 		}
 
+		bool FileExist(std::string path)
+		{
+#ifdef __GADT_GNUC
+			return (access(path.c_str(), 0) != -1);
+#elif defined(__GADT_MSVC)
+			return (_access(path.c_str(), 0) != -1);
+#endif
+		}
+
 		bool MakeDir(std::string path)
 		{
 			if (DirExist(path))
@@ -212,6 +268,99 @@ namespace gadt
 		}
 	}
 
+	namespace memory
+	{
+		const size_t VirtualMemory::_commit_chunk = 2 * 1024 * 1024;
+
+		VirtualMemory::VirtualMemory(size_t reserve_bytes, bool huge_page) :
+			_base(nullptr),
+			_reserved(0),
+			_committed(0),
+			_huge_page(huge_page)
+		{
+			if (reserve_bytes == 0)
+			{
+				return;
+			}
+			size_t bytes = (reserve_bytes + _commit_chunk - 1) / _commit_chunk * _commit_chunk;
+#ifdef __GADT_GNUC
+			void* p = mmap(nullptr, bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+			if (p == MAP_FAILED)
+			{
+				return;
+			}
+#ifdef MADV_HUGEPAGE
+			if (_huge_page)
+			{
+				madvise(p, bytes, MADV_HUGEPAGE);
+			}
+#endif
+#elif defined(__GADT_MSVC)
+			void* p = VirtualAlloc(nullptr, bytes, MEM_RESERVE, PAGE_NOACCESS);
+			if (p == nullptr)
+			{
+				return;
+			}
+#endif
+			_base = reinterpret_cast<char*>(p);
+			_reserved = bytes;
+		}
+
+		VirtualMemory::~VirtualMemory()
+		{
+			if (_base != nullptr)
+			{
+#ifdef __GADT_GNUC
+				munmap(_base, _reserved);
+#elif defined(__GADT_MSVC)
+				VirtualFree(_base, 0, MEM_RELEASE);
+#endif
+			}
+		}
+
+		bool VirtualMemory::commit(size_t bytes)
+		{
+			if (bytes <= _committed)
+			{
+				return true;
+			}
+			if (bytes > _reserved)
+			{
+				return false;
+			}
+			size_t target = (bytes + _commit_chunk - 1) / _commit_chunk * _commit_chunk;
+			target = target < _reserved ? target : _reserved;
+#ifdef __GADT_GNUC
+			if (mprotect(_base + _committed, target - _committed, PROT_READ | PROT_WRITE) != 0)
+			{
+				return false;
+			}
+#elif defined(__GADT_MSVC)
+			if (VirtualAlloc(_base + _committed, target - _committed, MEM_COMMIT, PAGE_READWRITE) == nullptr)
+			{
+				return false;
+			}
+#endif
+			_committed = target;
+			return true;
+		}
+
+		void VirtualMemory::decommit()
+		{
+			if (_committed == 0)
+			{
+				return;
+			}
+#ifdef __GADT_GNUC
+			madvise(_base, _committed, MADV_DONTNEED);
+			mprotect(_base, _committed, PROT_NONE);
+#elif defined(__GADT_MSVC)
+			VirtualFree(_base, _committed, MEM_DECOMMIT);
+#endif
+			_committed = 0;
+		}
+	}
+
 	namespace table
 	{
 		const size_t ConsoleTable::_default_width = 1;
@@ -27,6 +27,7 @@
 	#include <io.h>
 	#include <direct.h>
 	#include <tchar.h>
+	#include <intrin.h>
 #elif defined(__GNUC__)
 	#define __GADT_GNUC
 	#if (__GNUC__ * 10000 + __GNUC_MINOR__ * 100 + __GNUC_PATCHLEVEL__) < 40900
@@ -37,6 +38,7 @@
 	#include <errno.h> 
 	#include <unistd.h>
 	#include <dirent.h>
+	#include <sys/mman.h>
 #else
 	#error "unsupported compiler"
 #endif
@@ -56,7 +58,9 @@
 
 #include <stdlib.h>
 #include <math.h>
+#include <cmath>
 #include <stdio.h>
+#include <string.h>
 #include <time.h>
 #include <iostream>
 #include <fstream>
@@ -70,7 +74,14 @@
 #include <queue>
 #include <memory>
 #include <functional>
+#include <algorithm>
 #include <type_traits>
+#include <chrono>
+#include <limits>
+#include <cstddef>
+#include <thread>
+#include <mutex>
+#include <atomic>
 
 #pragma once
 
@@ -174,6 +185,9 @@ namespace gadt
 		//if 'condition' is true that report detail.
 		void WarningCheck(bool condition, std::string reason, std::string file, int line, std::string function);
 
+		//write warnings to stderr without pause if quiet is true, which is used if stdin and stdout are data streams.
+		void SetQuietWarning(bool quiet);
+
 		//system pause.
 		void SystemPause();
 
@@ -184,13 +198,14 @@ namespace gadt
 	namespace timer
 	{
 		std::string TimeString(std::string format = "%Y.%m.%d-%H:%M:%S");
+		size_t TimeString(char* buffer, size_t size, const char* format = "%Y.%m.%d-%H:%M:%S");
 		clock_t GetClock();
 		double GetTimeDifference(const clock_t& start);
 		
 		class TimePoint
 		{
 		private:
-			clock_t _clock;
+			std::chrono::steady_clock::time_point _clock;
 			time_t _time;
 		public:
 
@@ -205,14 +220,101 @@ namespace gadt
 			//set this time point to current time.
 			inline void reset()
 			{
-				_clock = clock();
+				_clock = std::chrono::steady_clock::now();
 				_time = time(NULL);
 			}
 
-			//get the time since this time point was created.
+			//get the wall time since this time point was created.
+			inline double time_since_created() const
+			{
+				return std::chrono::duration<double>(std::chrono::steady_clock::now() - _clock).count();
+			}
+		};
+
+		/*
+		* Deadline is a timeout checker based on the monotonic wall clock.
+		*
+		* is_timeout() reads the clock every time it is called.
+		* poll_timeout() only reads the clock once every N calls, N is adapted to the measured call rate
+		* so that the clock is read about once per poll period. it is designed for search iteration loops.
+		*/
+		class Deadline
+		{
+		private:
+			using Clock = std::chrono::steady_clock;
+
+			static constexpr double _default_poll_period = 0.001;	//expected seconds between two clock readings.
+			static constexpr size_t _max_poll_interval = 1 << 20;	//max calls between two clock readings.
+
+			Clock::time_point	_start;			//time point that the deadline was set.
+			Clock::time_point	_last_check;	//time point of last clock reading.
+			double				_timeout;		//timeout (seconds).
+			double				_poll_period;	//expected seconds between two clock readings.
+			size_t				_poll_interval;	//calls between two clock readings.
+			size_t				_countdown;		//calls remain before next clock reading.
+			bool				_expired;		//true if the deadline had been reached.
+
+			//read clock, adapt poll interval by the measured call rate and return true if timeout.
+			bool check_clock();
+
+		public:
+			inline Deadline(double timeout = 0)
+			{
+				reset(timeout);
+			}
+
+			//restart the deadline with a new timeout.
+			inline void reset(double timeout)
+			{
+				_start = Clock::now();
+				_last_check = _start;
+				_timeout = timeout;
+				_poll_period = timeout / 16 < _default_poll_period ? timeout / 16 : _default_poll_period;
+				_poll_interval = 1;
+				_countdown = 1;
+				_expired = timeout <= 0;
+			}
+
+			//get the wall time since the deadline was set.
 			inline double time_since_created() const
 			{
-				return (double)(clock() - _clock) / CLOCKS_PER_SEC;
+				return std::chrono::duration<double>(Clock::now() - _start).count();
+			}
+
+			//get the remain time before timeout.
+			inline double remain_time() const
+			{
+				return _timeout - time_since_created();
+			}
+
+			//get current count of calls between two clock readings.
+			inline size_t poll_interval() const
+			{
+				return _poll_interval;
+			}
+
+			//return true if timeout, the clock is read every time.
+			inline bool is_timeout()
+			{
+				if (!_expired)
+				{
+					_expired = time_since_created() >= _timeout;
+				}
+				return _expired;
+			}
+
+			//return true if timeout, the clock is only read once every poll_interval() calls.
+			inline bool poll_timeout()
+			{
+				if (_expired)
+				{
+					return true;
+				}
+				if (--_countdown != 0)
+				{
+					return false;
+				}
+				return check_clock();
 			}
 		};
 	}
@@ -320,6 +422,9 @@ namespace gadt
 	{
 		//return true if the folder exists.
 		bool DirExist(std::string path);
+
+		//return true if the file exists.
+		bool FileExist(std::string path);
 		
 		//create dir and return true if create successfully.
 		bool MakeDir(std::string path);
@@ -328,6 +433,80 @@ namespace gadt
 		bool RemoveDir(std::string path);
 	}
 
+	namespace memory
+	{
+		/*
+		* VirtualMemory reserves a range of virtual address space and commits pages on demand,
+		* so a large arena costs neither startup time nor resident memory until it is used.
+		* committed pages are zero-filled by the system.
+		* transparent huge pages can be requested to reduce TLB misses, which is only available on linux.
+		*/
+		class VirtualMemory
+		{
+		private:
+			static const size_t _commit_chunk;	//memory is committed by chunks, which is the size of a huge page.
+
+			char*	_base;
+			size_t	_reserved;
+			size_t	_committed;
+			bool	_huge_page;
+
+		public:
+			//reserve address space by bytes.
+			VirtualMemory(size_t reserve_bytes, bool huge_page = false);
+
+			//copy constructor is banned
+			VirtualMemory(const VirtualMemory&) = delete;
+
+			//release all the memory.
+			~VirtualMemory();
+
+			//make sure the first bytes are committed, return false if failed.
+			bool commit(size_t bytes);
+
+			//return committed pages to the system, the address space is still reserved.
+			void decommit();
+
+			//return true if the first bytes are committed.
+			inline bool is_committed(size_t bytes) const
+			{
+				return bytes <= _committed;
+			}
+
+			//get the first address of the memory.
+			inline void* data() const
+			{
+				return _base;
+			}
+
+			//get the bytes of reserved address space.
+			inline size_t reserved_bytes() const
+			{
+				return _reserved;
+			}
+
+			//get the bytes of committed memory.
+			inline size_t committed_bytes() const
+			{
+				return _committed;
+			}
+
+			//return true if transparent huge page is requested.
+			inline bool huge_page_enabled() const
+			{
+				return _huge_page;
+			}
+
+			//get info as string format
+			inline std::string info() const
+			{
+				std::stringstream ss;
+				ss << "{reserved: " << _reserved << ", committed: " << _committed << "}";
+				return ss.str();
+			}
+		};
+	}
+
 	namespace log
 	{
 		//error log class. 
@@ -367,6 +546,12 @@ namespace gadt
 				return _error_list.size() == 0;
 			}
 
+			//get the number of errors.
+			inline size_t size() const
+			{
+				return _error_list.size();
+			}
+
 			//output as json format.
 			inline std::string output() const
 			{
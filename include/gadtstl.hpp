@@ -184,6 +184,7 @@ namespace gadt
 			static const size_t		_size = sizeof(T);
 			const size_t			_count;
 			index_queue				_available_index;
+			memory::VirtualMemory	_memory;			//elements are committed on demand.
 			pointer					_fir_element;
 			bool*					_exist_element;
 
@@ -219,8 +220,7 @@ namespace gadt
 			//allocate memory
 			inline void alloc_memory(size_t count)
 			{
-				//_fir_element = reinterpret_cast<T*>(new char[count * _size]);
-				_fir_element = reinterpret_cast<T*>(calloc(count, _size));
+				_fir_element = reinterpret_cast<T*>(_memory.data());
 				_exist_element = new bool[count];
 			}
 
@@ -228,8 +228,7 @@ namespace gadt
 			inline void delete_memory()
 			{
 				delete[] _exist_element;
-				//delete[] _fir_element;
-				::free(_fir_element);
+				_memory.decommit();
 				_exist_element = nullptr;
 				_fir_element = nullptr;
 			}
@@ -267,9 +266,10 @@ namespace gadt
 
 		public:
 			//constructor function with allocation.
-			Allocator(size_t count) :
+			Allocator(size_t count, bool huge_page = false) :
 				_count(count),
 				_available_index(),
+				_memory(count * _size, huge_page),
 				_fir_element(nullptr),
 				_exist_element(nullptr)
 			{
@@ -280,10 +280,12 @@ namespace gadt
 			Allocator(const Allocator& target) :
 				_count(target._count),
 				_available_index(target._available_index),
+				_memory(target._count * _size, target._memory.huge_page_enabled()),
 				_fir_element(nullptr),
 				_exist_element(nullptr)
 			{
 				alloc_memory(_count);
+				_memory.commit(target._memory.committed_bytes());
 				for (size_t i = 0; i < _count; i++)
 				{
 					this->_exist_element[i] = target._exist_element[i];
@@ -325,6 +327,10 @@ namespace gadt
 				if (_available_index.empty() != true)
 				{
 					size_t index = _available_index.front();
+					if (!_memory.is_committed((index + 1) * _size) && !_memory.commit((index + 1) * _size))
+					{
+						return nullptr;
+					}
 					_exist_element[index] = true;
 					_available_index.pop();
 					pointer ptr = index_to_ptr(index);
@@ -382,13 +388,726 @@ namespace gadt
 			inline std::string info() const
 			{
 				std::stringstream ss;
-				ss << "{count : " << _count << ", remain: " << remain_size() << "}";
+				ss << "{count : " << _count << ", remain: " << remain_size() << ", memory: " << _memory.info() << "}";
 				return ss.str();
 			}
+			//get the virtual memory of the allocator, which reports reserved and committed bytes.
+			inline const memory::VirtualMemory& virtual_memory() const
+			{
+				return _memory;
+			}
 
 			
 		};
 
+		//get the index of the lowest set bit, the value must not be 0.
+		inline size_t TrailingZeroCount(uint64_t value)
+		{
+#ifdef __GADT_MSVC
+			unsigned long index;
+			_BitScanForward64(&index, value);
+			return size_t(index);
+#else
+			return size_t(__builtin_ctzll(value));
+#endif
+		}
+
+		//get the number of set bits.
+		inline size_t PopCount(uint64_t value)
+		{
+#ifdef __GADT_MSVC
+			return size_t(__popcnt64(value));
+#else
+			return size_t(__builtin_popcountll(value));
+#endif
+		}
+
+		//mix the bits of a 64-bit value, which is the finalizer of splitmix64.
+		inline uint64_t MixHash(uint64_t value)
+		{
+			value ^= value >> 30;
+			value *= 0xBF58476D1CE4E5B9ULL;
+			value ^= value >> 27;
+			value *= 0x94D049BB133111EBULL;
+			value ^= value >> 31;
+			return value;
+		}
+
+		/*
+		* ValueCache is a fixed size hash table which saves values by 64-bit keys, such as the eval of states.
+		*
+		* the number of slots is the largest power of two that fits in the memory size, and a new value always replaces the old one.
+		* the cache is lock-free and can be shared by threads. each slot saves the key xor the value bits,
+		* so a slot torn by concurrent writes fails the key check and is treated as a miss. key 0 is reserved for empty slots.
+		* hits and misses are counted by the counter of each thread, which are summed when they are read.
+		*
+		* [T] is the type of value, which must be trivially copyable and no larger than 64 bits.
+		*/
+		template<typename T>
+		class ValueCache
+		{
+			static_assert(sizeof(T) <= sizeof(uint64_t), "the value of ValueCache must be no larger than 64 bits.");
+
+		private:
+			struct Slot
+			{
+				std::atomic<uint64_t> check;	//key ^ value.
+				std::atomic<uint64_t> value;	//bits of value.
+			};
+
+			struct Counter
+			{
+				std::atomic<size_t>	hit;
+				std::atomic<size_t>	miss;
+				char				padding[64];	//avoid false sharing between counters.
+			};
+
+			static const size_t			_counter_count = 16;	//threads share counters in turn if there are more threads.
+
+			std::unique_ptr<Slot[]>		_slots;
+			size_t						_size;
+			uint64_t					_mask;			//mask to get index from key.
+			mutable Counter				_counters[_counter_count];
+
+		private:
+			//get the counter of the thread, each thread is given a counter at the first time.
+			inline Counter& thread_counter() const
+			{
+				static std::atomic<size_t> next_index(0);
+				thread_local size_t index = next_index.fetch_add(1, std::memory_order_relaxed) % _counter_count;
+				return _counters[index];
+			}
+
+		public:
+			//create cache by memory size in MB, the cache is disabled if the size is 0.
+			ValueCache(size_t memory_mb = 0) :
+				_slots(),
+				_size(0),
+				_mask(0)
+			{
+				resize(memory_mb);
+			}
+
+			//resize the cache by memory size in MB, all values would be cleared.
+			void resize(size_t memory_mb)
+			{
+				size_t max_count = memory_mb * 1024 * 1024 / sizeof(Slot);
+				size_t count = 0;
+				if (max_count > 0)
+				{
+					count = 1;
+					while (count * 2 <= max_count) { count *= 2; }
+				}
+				_slots.reset(count == 0 ? nullptr : new Slot[count]);
+				_size = count;
+				_mask = count == 0 ? 0 : count - 1;
+				clear();
+			}
+
+			//clear all values and counters, which must not be called while other threads are using the cache.
+			void clear()
+			{
+				for (size_t i = 0; i < _size; i++)
+				{
+					_slots[i].check.store(0, std::memory_order_relaxed);
+					_slots[i].value.store(0, std::memory_order_relaxed);
+				}
+				reset_counter();
+			}
+
+			//reset hit and miss counters.
+			inline void reset_counter()
+			{
+				for (Counter& counter : _counters)
+				{
+					counter.hit.store(0, std::memory_order_relaxed);
+					counter.miss.store(0, std::memory_order_relaxed);
+				}
+			}
+
+			//return true if the cache is enabled.
+			inline bool enabled() const
+			{
+				return _size != 0;
+			}
+
+			//get value by key, return false if not found.
+			inline bool probe(uint64_t key, T& value) const
+			{
+				const Slot& slot = _slots[key & _mask];
+				const uint64_t bits = slot.value.load(std::memory_order_relaxed);
+				const uint64_t check = slot.check.load(std::memory_order_relaxed);
+				if (key == 0 || (check ^ bits) != key)
+				{
+					thread_counter().miss.fetch_add(1, std::memory_order_relaxed);
+					return false;
+				}
+				memcpy(&value, &bits, sizeof(T));
+				thread_counter().hit.fetch_add(1, std::memory_order_relaxed);
+				return true;
+			}
+
+			//save the value of a key.
+			inline void store(uint64_t key, const T& value)
+			{
+				Slot& slot = _slots[key & _mask];
+				uint64_t bits = 0;
+				memcpy(&bits, &value, sizeof(T));
+				slot.value.store(bits, std::memory_order_relaxed);
+				slot.check.store(key ^ bits, std::memory_order_relaxed);
+			}
+
+			//get the number of slots.
+			inline size_t size() const
+			{
+				return _size;
+			}
+
+			//get the number of probes that found the value.
+			inline size_t hit_count() const
+			{
+				size_t count = 0;
+				for (const Counter& counter : _counters)
+				{
+					count += counter.hit.load(std::memory_order_relaxed);
+				}
+				return count;
+			}
+
+			//get the number of probes that did not find the value.
+			inline size_t miss_count() const
+			{
+				size_t count = 0;
+				for (const Counter& counter : _counters)
+				{
+					count += counter.miss.load(std::memory_order_relaxed);
+				}
+				return count;
+			}
+
+			//get the rate of hits in all probes.
+			inline double hit_rate() const
+			{
+				const size_t total = hit_count() + miss_count();
+				return total == 0 ? 0 : double(hit_count()) / double(total);
+			}
+
+			//get info as string format
+			inline std::string info() const
+			{
+				std::stringstream ss;
+				ss << "{slots: " << _size << ", hit: " << hit_count() << ", miss: " << miss_count() << "}";
+				return ss.str();
+			}
+		};
+
+		/*
+		* PoolAllocator is a memory allocator with the same interface as Allocator, whose memory is preallocate at the time when the object is created.
+		*
+		* free slots are linked by an intrusive free list, and slots that were never used are handed out by bump allocation,
+		* so creating the allocator and flushing it do not touch every slot. existence of elements is recorded by a bitmap,
+		* flush only destroys the elements that exist by scanning the bitmap below the bump watermark, and it is O(1) if T is trivially destructible.
+		*
+		* [T] is the class type.
+		* [is_debug] means some debug info would not be ignored if it is true. this may result in a little degradation of performance.
+		*/
+		template<typename T, bool _is_debug = false>
+		class PoolAllocator
+		{
+		private:
+			using pointer = T*;
+			using reference = T&;
+			using word = uint64_t;
+
+			//a slot keeps either an element or the index of next free slot.
+			union Slot
+			{
+				size_t next;
+				alignas(T) unsigned char data[sizeof(T)];
+			};
+
+			static const size_t		_word_bits = 64;
+			static const size_t		_null_index = std::numeric_limits<size_t>::max();
+			static constexpr bool	_trivial_flush = std::is_trivially_destructible<T>::value;
+
+			const size_t			_count;
+			memory::VirtualMemory	_memory;		//slots are committed on demand while the watermark grows.
+			Slot*					_fir_slot;
+			word*					_exist_bitmap;
+			size_t					_free_head;		//the first slot of the free list.
+			size_t					_watermark;		//slots after the watermark are never used.
+			size_t					_length;		//the number of exist elements.
+
+		private:
+			//get index by pointer.
+			inline size_t ptr_to_index(pointer p) const
+			{
+				return size_t(reinterpret_cast<Slot*>(p) - _fir_slot);
+			}
+
+			//get objecy prt by index.
+			inline pointer index_to_ptr(size_t index) const
+			{
+				return reinterpret_cast<pointer>(_fir_slot[index].data);
+			}
+
+			//the number of bitmap words.
+			inline size_t bitmap_size() const
+			{
+				return (_count + _word_bits - 1) / _word_bits;
+			}
+
+			//return true if the element of the index exist.
+			inline bool exist(size_t index) const
+			{
+				return ((_exist_bitmap[index / _word_bits] >> (index % _word_bits)) & 0x1) == 1;
+			}
+
+			//set existence of the element.
+			inline void set_exist(size_t index)
+			{
+				_exist_bitmap[index / _word_bits] |= word(1) << (index % _word_bits);
+			}
+
+			//reset existence of the element.
+			inline void reset_exist(size_t index)
+			{
+				_exist_bitmap[index / _word_bits] &= ~(word(1) << (index % _word_bits));
+			}
+
+			//destory element by index.
+			inline void destory_by_index(size_t index)
+			{
+				index_to_ptr(index)->~T();
+				reset_exist(index);
+				_fir_slot[index].next = _free_head;
+				_free_head = index;
+				_length--;
+			}
+
+			//get an available slot, return _null_index if the allocator is full.
+			inline size_t pop_index()
+			{
+				if (_free_head != _null_index)
+				{
+					size_t index = _free_head;
+					_free_head = _fir_slot[index].next;
+					return index;
+				}
+				if (_watermark < _count)
+				{
+					size_t bytes = (_watermark + 1) * sizeof(Slot);
+					if (!_memory.is_committed(bytes) && !_memory.commit(bytes))
+					{
+						return _null_index;
+					}
+					return _watermark++;
+				}
+				return _null_index;
+			}
+
+			//allocate memory
+			inline void alloc_memory(size_t)
+			{
+				_fir_slot = reinterpret_cast<Slot*>(_memory.data());
+				_exist_bitmap = reinterpret_cast<word*>(calloc(bitmap_size(), sizeof(word)));
+			}
+
+			//delete memory
+			inline void delete_memory()
+			{
+				::free(_exist_bitmap);
+				_memory.decommit();
+				_exist_bitmap = nullptr;
+				_fir_slot = nullptr;
+			}
+
+			//destroy all exist elements by scanning the bitmap, and clear the bitmap.
+			void destory_all()
+			{
+				const size_t used_words = (_watermark + _word_bits - 1) / _word_bits;
+				if (!_trivial_flush)
+				{
+					for (size_t i = 0; i < used_words; i++)
+					{
+						word w = _exist_bitmap[i];
+						while (w != 0)
+						{
+							index_to_ptr(i * _word_bits + TrailingZeroCount(w))->~T();
+							w &= w - 1;
+						}
+					}
+				}
+				memset(_exist_bitmap, 0, used_words * sizeof(word));
+				_free_head = _null_index;
+				_watermark = 0;
+				_length = 0;
+			}
+
+			//return the value of _is_debug.
+			constexpr inline bool is_debug() const
+			{
+				return _is_debug;
+			}
+
+		public:
+			//constructor function with allocation.
+			PoolAllocator(size_t count, bool huge_page = false) :
+				_count(count),
+				_memory(count * sizeof(Slot), huge_page),
+				_fir_slot(nullptr),
+				_exist_bitmap(nullptr),
+				_free_head(_null_index),
+				_watermark(0),
+				_length(0)
+			{
+				alloc_memory(count);
+			}
+
+			//copy constructor function, elements are copied to the same slots.
+			PoolAllocator(const PoolAllocator& target) :
+				_count(target._count),
+				_memory(target._count * sizeof(Slot), target._memory.huge_page_enabled()),
+				_fir_slot(nullptr),
+				_exist_bitmap(nullptr),
+				_free_head(target._free_head),
+				_watermark(target._watermark),
+				_length(target._length)
+			{
+				alloc_memory(_count);
+				_memory.commit(_watermark * sizeof(Slot));
+				memcpy(_exist_bitmap, target._exist_bitmap, bitmap_size() * sizeof(word));
+				for (size_t i = 0; i < _watermark; i++)
+				{
+					if (exist(i))
+					{
+						new (index_to_ptr(i)) T(*(target.index_to_ptr(i)));
+					}
+					else
+					{
+						_fir_slot[i].next = target._fir_slot[i].next;
+					}
+				}
+			}
+
+			//destructor function.
+			~PoolAllocator()
+			{
+				destory_all();
+				delete_memory();
+			}
+
+			//return true if the pointer is inside the memory of the allocator.
+			inline bool contains(pointer target) const
+			{
+				uintptr_t t = uintptr_t(target);
+				return t >= uintptr_t(_fir_slot) && t < uintptr_t(_fir_slot + _count);
+			}
+
+			//free space by ptr, return true if free successfully.
+			inline bool destory(pointer target)
+			{
+				uintptr_t t = uintptr_t(target);
+				uintptr_t fir = uintptr_t(_fir_slot);
+				uintptr_t last = uintptr_t(_fir_slot + _watermark);
+				if (target != nullptr && t >= fir && t < last && ((t - fir) % sizeof(Slot) == 0))
+				{
+					size_t index = ptr_to_index(target);
+					if (exist(index))
+					{
+						destory_by_index(index);
+						return true;
+					}
+				}
+				return false;
+			}
+
+			//copy source object to a empty space and return the pointer, return nullptr if there are not available space.
+			template<class... Types>
+			pointer construct(Types&&... args)
+			{
+				size_t index = pop_index();
+				if (index != _null_index)
+				{
+					set_exist(index);
+					_length++;
+					pointer ptr = index_to_ptr(index);
+					ptr = new (ptr) T(std::forward<Types>(args)...);//placement new;
+					return ptr;
+				}
+				return nullptr;
+			}
+
+			//total size of alloc.
+			inline size_t total_size() const
+			{
+				return _count;
+			}
+
+			//remain size in the alloc.
+			inline size_t remain_size() const
+			{
+				return _count - _length;
+			}
+
+			//return size of the allocator.
+			inline size_t size() const
+			{
+				return _length;
+			}
+
+			//return true if there is not available space in this allocator.
+			inline bool is_full() const
+			{
+				return _length == _count;
+			}
+
+			//return true if this allocator is empty.
+			inline bool is_empty() const
+			{
+				return _length == 0;
+			}
+
+			//flush all datas in the allocator.
+			inline void flush()
+			{
+				destory_all();
+			}
+
+			//get info as string format
+			inline std::string info() const
+			{
+				std::stringstream ss;
+				ss << "{count : " << _count << ", remain: " << remain_size() << ", watermark: " << _watermark << ", memory: " << _memory.info() << "}";
+				return ss.str();
+			}
+			//get the virtual memory of the allocator, which reports reserved and committed bytes.
+			inline const memory::VirtualMemory& virtual_memory() const
+			{
+				return _memory;
+			}
+		};
+
+		/*
+		* ConcurrentAllocator is a set of PoolAllocator shards, one for each thread, which is used by parallel searches.
+		*
+		* every thread constructs elements from its own shard without any lock. an element freed by another thread is kept
+		* in a pending batch of the freeing thread and is pushed to the inbox of the owner shard once the batch is full,
+		* then the owner destroys the elements in its inbox when it allocates next time. the size of each shard follows
+		* the global memory budget.
+		*
+		* [T] is the class type.
+		* [is_debug] means some debug info would not be ignored if it is true. this may result in a little degradation of performance.
+		*/
+		template<typename T, bool _is_debug = false>
+		class ConcurrentAllocator
+		{
+		public:
+			using pointer = T*;
+			using Pool = PoolAllocator<T, _is_debug>;
+
+		private:
+			static const size_t		_default_batch_size = 64;
+			static const size_t		_cache_line_size = 64;
+
+			struct Shard
+			{
+				Pool								pool;			//only accessed by the owner thread.
+				std::vector<std::vector<pointer>>	pending;		//elements freed by the owner thread but belong to other shards.
+				std::mutex							inbox_mutex;	//lock of the inbox.
+				std::vector<pointer>				inbox;			//elements freed by other threads.
+				std::atomic<size_t>					inbox_size;		//size of inbox, which is checked without lock.
+				char								padding[_cache_line_size];	//avoid false sharing between shards.
+
+				Shard(size_t count, size_t shard_count) :
+					pool(count),
+					pending(shard_count),
+					inbox_mutex(),
+					inbox(),
+					inbox_size(0)
+				{
+				}
+			};
+
+			const size_t						_shard_count;
+			const size_t						_batch_size;
+			std::vector<std::unique_ptr<Shard>>	_shards;
+
+		private:
+			//get the index of the shard that owns the pointer, return _shard_count if not found.
+			inline size_t owner_of(pointer target) const
+			{
+				for (size_t i = 0; i < _shard_count; i++)
+				{
+					if (_shards[i]->pool.contains(target))
+					{
+						return i;
+					}
+				}
+				return _shard_count;
+			}
+
+			//destroy the elements in the inbox of the shard, which is called by the owner thread.
+			void drain_inbox(size_t thread_index)
+			{
+				Shard& shard = *_shards[thread_index];
+				if (shard.inbox_size.load(std::memory_order_acquire) == 0)
+				{
+					return;
+				}
+				std::vector<pointer> received;
+				{
+					std::lock_guard<std::mutex> lock(shard.inbox_mutex);
+					received.swap(shard.inbox);
+					shard.inbox_size.store(0, std::memory_order_release);
+				}
+				for (pointer p : received)
+				{
+					bool b = shard.pool.destory(p);
+					GADT_CHECK_WARNING(is_debug(), b == false, "free element in inbox failed.");
+				}
+			}
+
+			//push a batch of freed elements to the inbox of the owner.
+			void send_batch(size_t thread_index, size_t owner_index)
+			{
+				std::vector<pointer>& batch = _shards[thread_index]->pending[owner_index];
+				if (batch.empty())
+				{
+					return;
+				}
+				Shard& owner = *_shards[owner_index];
+				{
+					std::lock_guard<std::mutex> lock(owner.inbox_mutex);
+					owner.inbox.insert(owner.inbox.end(), batch.begin(), batch.end());
+					owner.inbox_size.store(owner.inbox.size(), std::memory_order_release);
+				}
+				batch.clear();
+			}
+
+			//return the value of _is_debug.
+			constexpr inline bool is_debug() const
+			{
+				return _is_debug;
+			}
+
+		public:
+			//get the number of elements per shard that fits in the memory budget.
+			static size_t count_by_budget(size_t memory_budget, size_t shard_count)
+			{
+				return shard_count == 0 ? 0 : memory_budget / sizeof(T) / shard_count;
+			}
+
+			//constructor function, memory_budget is the total bytes of all shards.
+			ConcurrentAllocator(size_t shard_count, size_t memory_budget, size_t batch_size = _default_batch_size) :
+				_shard_count(shard_count),
+				_batch_size(batch_size),
+				_shards()
+			{
+				const size_t count = count_by_budget(memory_budget, shard_count);
+				for (size_t i = 0; i < _shard_count; i++)
+				{
+					_shards.push_back(std::unique_ptr<Shard>(new Shard(count, _shard_count)));
+				}
+			}
+
+			ConcurrentAllocator(const ConcurrentAllocator&) = delete;
+
+			//construct an element in the shard of the thread, return nullptr if the shard is full.
+			template<class... Types>
+			pointer construct(size_t thread_index, Types&&... args)
+			{
+				GADT_CHECK_WARNING(is_debug(), thread_index >= _shard_count, "thread index out of range.");
+				drain_inbox(thread_index);
+				return _shards[thread_index]->pool.construct(std::forward<Types>(args)...);
+			}
+
+			//free an element by the thread, elements of other shards are freed in batch. return true if free successfully.
+			bool destory(size_t thread_index, pointer target)
+			{
+				GADT_CHECK_WARNING(is_debug(), thread_index >= _shard_count, "thread index out of range.");
+				if (_shards[thread_index]->pool.contains(target))
+				{
+					return _shards[thread_index]->pool.destory(target);
+				}
+				size_t owner_index = owner_of(target);
+				if (owner_index == _shard_count)
+				{
+					return false;
+				}
+				std::vector<pointer>& batch = _shards[thread_index]->pending[owner_index];
+				batch.push_back(target);
+				if (batch.size() >= _batch_size)
+				{
+					send_batch(thread_index, owner_index);
+				}
+				return true;
+			}
+
+			//push all pending frees of the thread to their owners, which should be called when the thread finish its work.
+			void commit(size_t thread_index)
+			{
+				for (size_t i = 0; i < _shard_count; i++)
+				{
+					send_batch(thread_index, i);
+				}
+			}
+
+			//get the shard of the thread.
+			inline Pool& shard(size_t thread_index)
+			{
+				return _shards[thread_index]->pool;
+			}
+
+			//return true if there is not available space in the shard of the thread.
+			inline bool is_full(size_t thread_index) const
+			{
+				return _shards[thread_index]->pool.is_full();
+			}
+
+			//the number of shards.
+			inline size_t shard_count() const
+			{
+				return _shard_count;
+			}
+
+			//total size of all shards.
+			inline size_t total_size() const
+			{
+				size_t sum = 0;
+				for (const auto& p : _shards) { sum += p->pool.total_size(); }
+				return sum;
+			}
+
+			//return size of all shards, which is not thread-safe.
+			inline size_t size() const
+			{
+				size_t sum = 0;
+				for (const auto& p : _shards) { sum += p->pool.size(); }
+				return sum;
+			}
+
+			//flush all shards, which must not be called while any thread is using the allocator.
+			void flush()
+			{
+				for (auto& p : _shards)
+				{
+					for (auto& batch : p->pending) { batch.clear(); }
+					p->inbox.clear();
+					p->inbox_size.store(0);
+					p->pool.flush();
+				}
+			}
+
+			//get info as string format
+			inline std::string info() const
+			{
+				std::stringstream ss;
+				ss << "{shards : " << _shard_count << ", count : " << total_size() << ", size: " << size() << "}";
+				return ss.str();
+			}
+		};
+
 		/*
 		* ListNode is the basic unit of gadt::stl::List.
 		*
@@ -426,13 +1145,14 @@ namespace gadt
 		*
 		* [T] is the class type of the link list.
 		* [is_debug] means some debug info would not be ignored if it is true. this may result in a little degradation of performance.
+		* [AllocatorType] is the template of node allocator, which can be Allocator or PoolAllocator.
 		*/
-		template<typename T, bool _is_debug = false>
+		template<typename T, bool _is_debug = false, template<typename, bool> class AllocatorType = Allocator>
 		class List
 		{
 		public:
 			using Node = ListNode<T, _is_debug>;
-			using Allocator = gadt::stl::Allocator<Node, _is_debug>;
+			using Allocator = AllocatorType<Node, _is_debug>;
 			using node_pointer = Node*;
 
 		private:
@@ -569,21 +1289,21 @@ namespace gadt
 
 			static const size_t		_size = sizeof(T);
 			const size_t			_count;
+			memory::VirtualMemory	_memory;		//elements are committed on demand while the length grows.
 			pointer					_fir_element;
 			size_t					_length;
 
 		private:
 			//allocate memory
-			inline void alloc_memory(size_t count)
+			inline void alloc_memory(size_t)
 			{
-				_fir_element = reinterpret_cast<T*>(calloc(count, _size));
+				_fir_element = reinterpret_cast<T*>(_memory.data());
 			}
 
 			//delete memory
 			inline void delete_memory()
 			{
-				//delete[] _fir_element;
-				::free(_fir_element);
+				_memory.decommit();
 				_fir_element = nullptr;
 				_length = 0;
 			}
@@ -596,8 +1316,9 @@ namespace gadt
 
 		public:
 			//constructor function with allocation.
-			LinearAllocator(size_t count) :
+			LinearAllocator(size_t count, bool huge_page = false) :
 				_count(count),
+				_memory(count * _size, huge_page),
 				_fir_element(nullptr),
 				_length(0)
 			{
@@ -607,6 +1328,7 @@ namespace gadt
 			//copy constructor function.
 			LinearAllocator(const LinearAllocator& target) :
 				_count(target._count),
+				_memory(target._count * _size, target._memory.huge_page_enabled()),
 				_fir_element(nullptr),
 				_length(0)
 			{
@@ -642,6 +1364,10 @@ namespace gadt
 			{
 				if (is_full() == false)
 				{
+					if (!_memory.is_committed((_length + 1) * _size) && !_memory.commit((_length + 1) * _size))
+					{
+						return nullptr;
+					}
 					pointer ptr = _fir_element + _length;
 					_length++;
 					ptr = new (ptr) T(std::forward<Types>(args)...);//placement new;
@@ -697,9 +1423,14 @@ namespace gadt
 			inline std::string info() const
 			{
 				std::stringstream ss;
-				ss << "{count : " << _count << ", remain: " << remain_size() << "}";
+				ss << "{count : " << _count << ", remain: " << remain_size() << ", memory: " << _memory.info() << "}";
 				return ss.str();
 			}
+			//get the virtual memory of the allocator, which reports reserved and committed bytes.
+			inline const memory::VirtualMemory& virtual_memory() const
+			{
+				return _memory;
+			}
 
 			
 
@@ -708,10 +1439,204 @@ namespace gadt
 				return element(index);
 			}
 		};
+
+		/*
+		* ArenaAllocator hands out arrays of trivially destructible elements from big chunks by bump allocation.
+		*
+		* arrays can not be freed one by one. flush resets the arena at once and keeps the chunks for next use,
+		* so an object that keeps its arrays in the arena can be discarded without calling its destructor.
+		*/
+		class ArenaAllocator
+		{
+		private:
+			struct Chunk
+			{
+				unsigned char*	data;
+				size_t			size;
+			};
+
+			const size_t		_chunk_size;	//size of a common chunk, a larger array is given a chunk of its own size.
+			std::vector<Chunk>	_chunks;		//chunks are kept after flush.
+			size_t				_current;		//index of the chunk that is used now.
+			size_t				_offset;		//used bytes of the current chunk.
+			size_t				_used_bytes;	//bytes that are handed out since last flush.
+
+		public:
+			//constructor function, no chunk is allocated until the first array.
+			ArenaAllocator(size_t chunk_size) :
+				_chunk_size(chunk_size),
+				_chunks(),
+				_current(0),
+				_offset(0),
+				_used_bytes(0)
+			{
+			}
+
+			//copy constructor is banned.
+			ArenaAllocator(const ArenaAllocator&) = delete;
+
+			//destructor function, release all chunks.
+			~ArenaAllocator()
+			{
+				for (const Chunk& chunk : _chunks)
+				{
+					::free(chunk.data);
+				}
+			}
+
+			//get the memory of bytes whose address is aligned, return nullptr if failed.
+			void* allocate(size_t bytes, size_t align)
+			{
+				for (; _current < _chunks.size(); _current++, _offset = 0)
+				{
+					size_t begin = (_offset + align - 1) & ~(align - 1);
+					if (begin + bytes <= _chunks[_current].size)
+					{
+						_offset = begin + bytes;
+						_used_bytes += bytes;
+						return _chunks[_current].data + begin;
+					}
+				}
+				const size_t chunk_size = bytes > _chunk_size ? bytes : _chunk_size;
+				Chunk chunk = { reinterpret_cast<unsigned char*>(::malloc(chunk_size)), chunk_size };
+				if (chunk.data == nullptr)
+				{
+					return nullptr;
+				}
+				_chunks.push_back(chunk);
+				_current = _chunks.size() - 1;
+				_offset = bytes;
+				_used_bytes += bytes;
+				return chunk.data;
+			}
+
+			//get an array of count elements, which are not constructed.
+			template<typename T>
+			T* allocate_array(size_t count)
+			{
+				static_assert(std::is_trivially_destructible<T>::value, "elements in arena would never be destroyed.");
+				static_assert(alignof(T) <= alignof(std::max_align_t), "chunks are aligned by malloc.");
+				return count == 0 ? nullptr : reinterpret_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+			}
+
+			//discard all the arrays, the chunks are kept.
+			inline void flush()
+			{
+				_current = 0;
+				_offset = 0;
+				_used_bytes = 0;
+			}
+
+			//bytes that are handed out since last flush.
+			inline size_t used_bytes() const
+			{
+				return _used_bytes;
+			}
+
+			//bytes of all the chunks.
+			inline size_t reserved_bytes() const
+			{
+				size_t bytes = 0;
+				for (const Chunk& chunk : _chunks)
+				{
+					bytes += chunk.size;
+				}
+				return bytes;
+			}
+
+			//get info as string format
+			inline std::string info() const
+			{
+				std::stringstream ss;
+				ss << "{chunks: " << _chunks.size() << ", used: " << used_bytes() << ", reserved: " << reserved_bytes() << "}";
+				return ss.str();
+			}
+		};
+
+		/*
+		* ArenaArray is an array whose elements are kept in an ArenaAllocator.
+		*
+		* it never frees the elements and it is trivially destructible, the elements are discarded by flushing the arena.
+		*/
+		template<typename T>
+		class ArenaArray
+		{
+		private:
+			T*		_data;
+			size_t	_size;
+
+		public:
+			ArenaArray() :
+				_data(nullptr),
+				_size(0)
+			{
+			}
+
+			//get count elements from the arena and set them to the value. the array would be empty if the arena failed.
+			void assign(ArenaAllocator& arena, size_t count, const T& value)
+			{
+				_data = arena.allocate_array<T>(count);
+				_size = _data == nullptr ? 0 : count;
+				std::uninitialized_fill(_data, _data + _size, value);
+			}
+
+			//get elements from the arena and copy them from the range.
+			template<typename Iterator>
+			void assign(ArenaAllocator& arena, Iterator first, Iterator last)
+			{
+				size_t count = size_t(std::distance(first, last));
+				_data = arena.allocate_array<T>(count);
+				_size = _data == nullptr ? 0 : count;
+				if (_data != nullptr)
+				{
+					std::uninitialized_copy(first, last, _data);
+				}
+			}
+
+			inline size_t	size()						const { return _size; }
+			inline bool		empty()						const { return _size == 0; }
+			inline T*		data()						const { return _data; }
+			inline T*		begin()						const { return _data; }
+			inline T*		end()						const { return _data + _size; }
+			inline T&		back()						const { return _data[_size - 1]; }
+			inline T&		operator[](size_t index)	const { return _data[index]; }
+		};
 	}
 
 	namespace random
 	{
+		//get the state of the random generator of the thread, which is seeded by the thread id and clock.
+		inline uint64_t& ThreadRandState()
+		{
+			thread_local uint64_t state = stl::MixHash(
+				uint64_t(std::hash<std::thread::id>()(std::this_thread::get_id())) ^
+				uint64_t(std::chrono::steady_clock::now().time_since_epoch().count())) | 1;
+			return state;
+		}
+
+		//set the seed of the random generator of the thread.
+		inline void SeedThreadRand(uint64_t seed)
+		{
+			ThreadRandState() = stl::MixHash(seed) | 1;
+		}
+
+		//get a random number by the generator of the thread, which is xorshift64*.
+		//it is faster than rand() and no state is shared between threads.
+		inline uint64_t ThreadRand()
+		{
+			uint64_t& state = ThreadRandState();
+			state ^= state >> 12;
+			state ^= state << 25;
+			state ^= state >> 27;
+			return state * 0x2545F4914F6CDD1DULL;
+		}
+
+		//get a random index in [0, bound) by the generator of the thread.
+		inline size_t RandomIndex(size_t bound)
+		{
+			return size_t(ThreadRand() % bound);
+		}
+
 		template<typename T>
 		struct RandomPoolElement
 		{
@@ -821,7 +1746,7 @@ namespace gadt
 			inline const reference random() const
 			{
 				GADT_CHECK_WARNING(_is_debug, size() == 0, "random pool is empty.");
-				size_t rnd = rand() % _accumulated_range;
+				size_t rnd = RandomIndex(_accumulated_range);
 				for (size_t i = 0; i < size(); i++)
 				{
 					if (_ele_alloc[i]->lower_limit >= rnd)
@@ -31,6 +31,12 @@
 #include "visual_tree.h"
 #include "gadtstl.hpp"
 
+//SSE2 is used by the selection kernel if the target supports it.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define GADT_MCTS_SSE2
+	#include <emmintrin.h>
+#endif
+
 #pragma once
 
 namespace gadt
@@ -49,6 +55,14 @@ namespace gadt
 			TREE_PARALLELIZATION = 3
 		};
 
+		//proven value of a node in MCTS-Solver, from the view of the player who take the action to the node.
+		enum ProvenValue : uint8_t
+		{
+			NOT_PROVEN = 0,
+			PROVEN_WIN = 1,
+			PROVEN_LOSS = 2
+		};
+
 		//AgentIndex is the type index of each player, default is int8_t.
 		using AgentIndex		= int8_t;
 		using UcbValue			= double;
@@ -59,6 +73,152 @@ namespace gadt
 			{
 				return average_reward + c * static_cast<UcbValue>(sqrt(2 * log10(overall_time) / played_time));
 			}
+
+			//get the parent term of UCB1, which is shared by all children of the parent.
+			inline float UCB1ParentTerm(uint32_t overall_time)
+			{
+				return 2 * log10f(static_cast<float>(overall_time));
+			}
+
+			//get the weight of AMAF value in RAVE, which decays with the visited time of the child.
+			inline float RaveBeta(float played_time, float equivalence)
+			{
+				return sqrtf(equivalence / (3 * played_time + equivalence));
+			}
+
+#ifdef GADT_MCTS_SSE2
+			//BestLanes keeps the highest value and its index in each of the four lanes.
+			struct BestLanes
+			{
+				__m128	value;
+				__m128i	index;
+				__m128i	next_index;
+
+				BestLanes() :
+					value(_mm_set1_ps(-std::numeric_limits<float>::max())),
+					index(_mm_setzero_si128()),
+					next_index(_mm_setr_epi32(0, 1, 2, 3))
+				{
+				}
+
+				//compare four values of next four indexes.
+				inline void update(__m128 new_value)
+				{
+					__m128 greater = _mm_cmpgt_ps(new_value, value);
+					__m128i greater_i = _mm_castps_si128(greater);
+					value = _mm_or_ps(_mm_and_ps(greater, new_value), _mm_andnot_ps(greater, value));
+					index = _mm_or_si128(_mm_and_si128(greater_i, next_index), _mm_andnot_si128(greater_i, index));
+					next_index = _mm_add_epi32(next_index, _mm_set1_epi32(4));
+				}
+
+				//reduce lanes, lower index wins if the values are equal.
+				inline void reduce(float& best_value, size_t& best_index) const
+				{
+					float lane_value[4];
+					int32_t lane_index[4];
+					_mm_storeu_ps(lane_value, value);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(lane_index), index);
+					best_value = lane_value[0];
+					best_index = static_cast<size_t>(lane_index[0]);
+					for (size_t n = 1; n < 4; n++)
+					{
+						size_t lane = static_cast<size_t>(lane_index[n]);
+						if (lane_value[n] > best_value || (lane_value[n] == best_value && lane < best_index))
+						{
+							best_value = lane_value[n];
+							best_index = lane;
+						}
+					}
+				}
+			};
+#endif
+
+			/*
+			* select the index of the child with the highest UCB1 value.
+			*
+			* [win] and [visit] are contiguous arrays of win time and visited time of the children.
+			* [parent_term] is the value of UCB1ParentTerm of the parent.
+			* [c] is the exploration constant.
+			* the first one would be selected if several children have the same value.
+			*/
+			inline size_t UCB1Select(const float* win, const float* visit, size_t size, float parent_term, float c)
+			{
+				float best_value = -std::numeric_limits<float>::max();
+				size_t best_index = 0;
+				size_t i = 0;
+#ifdef GADT_MCTS_SSE2
+				if (size >= 4)
+				{
+					const __m128 term_v = _mm_set1_ps(parent_term);
+					const __m128 c_v = _mm_set1_ps(c);
+					BestLanes lanes;
+					for (; i + 4 <= size; i += 4)
+					{
+						__m128 visit_v = _mm_loadu_ps(visit + i);
+						__m128 avg_v = _mm_div_ps(_mm_loadu_ps(win + i), visit_v);
+						lanes.update(_mm_add_ps(avg_v, _mm_mul_ps(c_v, _mm_sqrt_ps(_mm_div_ps(term_v, visit_v)))));
+					}
+					lanes.reduce(best_value, best_index);
+				}
+#endif
+				for (; i < size; i++)
+				{
+					float value = win[i] / visit[i] + c * sqrtf(parent_term / visit[i]);
+					if (value > best_value)
+					{
+						best_value = value;
+						best_index = i;
+					}
+				}
+				return best_index;
+			}
+
+			/*
+			* select the index of the child with the highest UCB1 value, whose average reward is
+			* blended with AMAF average reward by a decaying weight (RAVE).
+			*
+			* [amaf_win] and [amaf_visit] are contiguous arrays of AMAF statistics of the children.
+			* [equivalence] is the visited time at which the weights of both average rewards are nearly equal.
+			*/
+			inline size_t RaveUCB1Select(const float* win, const float* visit, const float* amaf_win, const float* amaf_visit, size_t size, float parent_term, float c, float equivalence)
+			{
+				float best_value = -std::numeric_limits<float>::max();
+				size_t best_index = 0;
+				size_t i = 0;
+#ifdef GADT_MCTS_SSE2
+				if (size >= 4)
+				{
+					const __m128 term_v = _mm_set1_ps(parent_term);
+					const __m128 c_v = _mm_set1_ps(c);
+					const __m128 k_v = _mm_set1_ps(equivalence);
+					const __m128 three_v = _mm_set1_ps(3);
+					const __m128 one_v = _mm_set1_ps(1);
+					BestLanes lanes;
+					for (; i + 4 <= size; i += 4)
+					{
+						__m128 visit_v = _mm_loadu_ps(visit + i);
+						__m128 avg_v = _mm_div_ps(_mm_loadu_ps(win + i), visit_v);
+						__m128 amaf_avg_v = _mm_div_ps(_mm_loadu_ps(amaf_win + i), _mm_loadu_ps(amaf_visit + i));
+						__m128 beta_v = _mm_sqrt_ps(_mm_div_ps(k_v, _mm_add_ps(_mm_mul_ps(three_v, visit_v), k_v)));
+						__m128 mixed_v = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(one_v, beta_v), avg_v), _mm_mul_ps(beta_v, amaf_avg_v));
+						lanes.update(_mm_add_ps(mixed_v, _mm_mul_ps(c_v, _mm_sqrt_ps(_mm_div_ps(term_v, visit_v)))));
+					}
+					lanes.reduce(best_value, best_index);
+				}
+#endif
+				for (; i < size; i++)
+				{
+					float beta = RaveBeta(visit[i], equivalence);
+					float mixed = (1 - beta) * (win[i] / visit[i]) + beta * (amaf_win[i] / amaf_visit[i]);
+					float value = mixed + c * sqrtf(parent_term / visit[i]);
+					if (value > best_value)
+					{
+						best_value = value;
+						best_index = i;
+					}
+				}
+				return best_index;
+			}
 		}
 
 		/*
@@ -72,27 +232,90 @@ namespace gadt
 			double	timeout;			//set timeout (seconds).
 			size_t	max_iteration;		//set max iteration times.
 			bool	gc_enabled;			//allow garbage collection if the tree run out of memory.
+			float	ucb_exploration;	//exploration constant of the default UCB1 tree policy.
+			bool	rave_enabled;		//blend AMAF statistics into the default tree policy, need ActionToKey function.
+			float	rave_equivalence;	//visited time at which the weights of direct and AMAF statistics are nearly equal.
+			bool	solver_enabled;		//propagate proven wins and losses of terminal states (MCTS-Solver).
 
 										//default setting constructor.
 			MctsSetting() :
 				timeout(30),
 				max_iteration(10000),
-				gc_enabled(false)
+				gc_enabled(false),
+				ucb_exploration(1),
+				rave_enabled(false),
+				rave_equivalence(1000),
+				solver_enabled(false)
 			{
 			}
 
 			//custom setting constructor.
-			MctsSetting(double _timeout, size_t _max_iteration, bool _gc_enabled) :
+			MctsSetting(double _timeout, size_t _max_iteration, bool _gc_enabled, float _ucb_exploration = 1, bool _rave_enabled = false, float _rave_equivalence = 1000, bool _solver_enabled = false) :
 				timeout(_timeout),
 				max_iteration(_max_iteration),
-				gc_enabled(_gc_enabled)
+				gc_enabled(_gc_enabled),
+				ucb_exploration(_ucb_exploration),
+				rave_enabled(_rave_enabled),
+				rave_equivalence(_rave_equivalence),
+				solver_enabled(_solver_enabled)
 			{
 			}
 		};
 
+		/*
+		* AmafRecord is the set of action keys that appear after a node in one iteration, which is used by RAVE.
+		*
+		* each key is recorded with the parity of the ply it is played at, counted from the root. players are assumed to
+		* move alternately along the tree and playouts, so a node only matches the keys played by its own player.
+		* the key of action should be a small integer, because the record is indexed by keys.
+		*/
+		class AmafRecord
+		{
+		private:
+			std::vector<size_t>		_keys;		//keys in the record.
+			std::vector<uint8_t>	_exist;		//flags of each key, bit 0 for even plies and bit 1 for odd plies.
+
+		public:
+			//add a key played at the ply to the record.
+			inline void add(size_t key, size_t ply)
+			{
+				if (key >= _exist.size())
+				{
+					_exist.resize(key + 1, 0);
+				}
+				if (_exist[key] == 0)
+				{
+					_keys.push_back(key);
+				}
+				_exist[key] |= uint8_t(1 << (ply & 1));
+			}
+
+			//return true if the key is played at any ply with the same parity as the ply.
+			inline bool exist(size_t key, size_t ply) const
+			{
+				return key < _exist.size() && (_exist[key] & (1 << (ply & 1))) != 0;
+			}
+
+			//clear the record, the memory is kept for next iteration.
+			inline void clear()
+			{
+				for (size_t key : _keys)
+				{
+					_exist[key] = 0;
+				}
+				_keys.clear();
+			}
+		};
+
+		template<typename State, typename Action, typename Result, bool _is_debug>
+		class MctsAllocator;
+
 		/*
 		* MctsNode is the node class in the monte carlo tree search.
 		*
+		* the arrays of the node are kept in the arena of the allocator, so the node owns no memory out of the allocator
+		* and it is trivially destructible if State, Action and Result are.
+		*
 		* [State] is the game-state class, which is defined by the user.
 		* [Action] is the game-action class, which is defined by the user.
 		* [Result] is the game-result class, which stand for a terminal state of the game.
@@ -105,9 +328,10 @@ namespace gadt
 			using pointer       = MctsNode<State, Action, Result, _is_debug>*;
 			using reference     = MctsNode<State, Action, Result, _is_debug>&;
 			using Node			= MctsNode<State, Action, Result, _is_debug>;		//MctsNode
-			using Allocator		= gadt::stl::Allocator<Node, _is_debug>;			//Allocate 
+			using Allocator		= MctsAllocator<State, Action, Result, _is_debug>;	//Allocator of nodes, the tree can be discarded by flush.
 			using ActionSet		= std::vector<Action>;								//ActionSet is the set of Action.
-			using NodePtrSet	= std::vector<pointer>;							//ChildSet is the set of ptrs to child nodes.
+			using ActionArray	= gadt::stl::ArenaArray<Action>;					//ActionArray is the set of Action kept in the arena.
+			using NodePtrSet	= gadt::stl::ArenaArray<pointer>;					//ChildSet is the set of ptrs to child nodes.
 			
 			//function package
 			struct FuncPackage
@@ -123,6 +347,11 @@ namespace gadt
 				using AllowExtendFunc		= std::function<bool(const Node&)>;					
 				using AllowExcuteGcFunc		= std::function<bool(const Node&)>;					
 				using ValueForRootNodeFunc	= std::function<UcbValue(const Node&)>;				
+				using ActionToKeyFunc		= std::function<size_t(const Action&)>;
+				using ResultIsDrawFunc		= std::function<bool(const Result&)>;
+				using SimulationFunc		= std::function<Result(const State&)>;
+				using IsChanceStateFunc		= std::function<bool(const State&)>;
+				using ChanceWeightFunc		= std::function<size_t(const State&, const Action&)>;
 
 			public:
 				//necessary functions.
@@ -133,12 +362,19 @@ namespace gadt
 				const AllowUpdateValueFunc	AllowUpdateValue;	//update values in the node by the result.
 
 				//default functions.
-				TreePolicyValueFunc			TreePolicyValue;	//value of child node in selection process. the highest would be seleced.
+				TreePolicyValueFunc			TreePolicyValue;	//value of child node in selection process. the highest would be seleced. vectorized UCB1 is used if it is empty.
 				DefaultPolicyFunc			DefaultPolicy;		//the default policy to select action.
 				AllowExtendFunc				AllowExtend;		//allow node to extend child node.
 				AllowExcuteGcFunc			AllowExcuteGc;		//the condition to excute gc in a node.
 				ValueForRootNodeFunc		ValueForRootNode;	//select best action of root node after iterations finished.
 
+				//optional functions.
+				ActionToKeyFunc				ActionToKey;		//get the key of action for AMAF statistics, RAVE is disabled if it is empty.
+				ResultIsDrawFunc			ResultIsDraw;		//return true if the result is draw, MCTS-Solver treats any result that is not win as loss if it is empty.
+				SimulationFunc				Simulation;			//get the result of a non-terminal state directly instead of the default policy playout, such as sampling by a value network.
+				IsChanceStateFunc			IsChanceState;		//return true if the actions of the state are outcomes of chance, no chance node exists if it is empty.
+				ChanceWeightFunc			ChanceWeight;		//get the weight of an outcome of a chance state, the probability of the outcome is proportional to it.
+
 			public:
 				FuncPackage(
 					GetNewStateFunc			_GetNewState,
@@ -184,23 +420,35 @@ namespace gadt
 		private:
 			State			_state;				//state of this node.
 			AgentIndex		_winner_index;		//the winner index of the state.
+			bool			_is_chance;			//the actions are outcomes of chance, which are sampled by weights instead of tree policy.
 			uint32_t		_visited_time;		//how many times that this node had been visited.
 			uint32_t		_win_time;			//win time accmulated by the simulation.
 			uint8_t			_next_action_index;	//the index of next action.
-			ActionSet		_action_set;		//action set of this node.
+			ProvenValue		_proven_value;		//proven value of the node in MCTS-Solver.
+			uint8_t			_proven_loss_child;	//the number of child nodes that are proven loss.
+			Result			_proven_result;		//the result that is back propagated if the node is proven.
+			ActionArray		_action_set;		//action set of this node.
 			NodePtrSet		_child_nodes;		//the ptr of child nodes.
+			gadt::stl::ArenaArray<float>	_child_visited_time;	//visited time of each child, contiguous for the selection kernel.
+			gadt::stl::ArenaArray<float>	_child_win_time;		//win time of each child, contiguous for the selection kernel.
+			gadt::stl::ArenaArray<size_t>	_action_keys;			//key of each action, only exist if RAVE is enabled.
+			gadt::stl::ArenaArray<float>	_child_amaf_visited_time;	//AMAF visited time of each action.
+			gadt::stl::ArenaArray<float>	_child_amaf_win_time;		//AMAF win time of each action.
+			gadt::stl::ArenaArray<size_t>	_outcome_weight;			//accumulated weights of outcomes, only exist in chance node.
 
 		public:
 			const State&		state()					const { return _state; }
 			const AgentIndex	winner_index()			const { return _winner_index; }
+			const bool			is_chance()				const { return _is_chance; }
 			const uint32_t		visited_time()			const { return _visited_time; }
 			const uint32_t		win_time()				const { return _win_time; }
 			const uint8_t		next_action_index()		const { return _next_action_index; }
+			const ProvenValue	proven_value()			const { return _proven_value; }
 			const size_t		child_num()				const { return _child_nodes.size(); }
 			const NodePtrSet&	child_set()				const { return _child_nodes; }
 			const MctsNode*		child_node(size_t i)	const { return _child_nodes[i]; }
 			const size_t		action_num()			const { return _action_set.size(); }
-			const ActionSet&	action_set()			const { return _action_set; }
+			const ActionArray&	action_set()			const { return _action_set; }
 			const Action&		action(size_t i)		const { return _action_set[i]; }
 
 		private:
@@ -208,6 +456,9 @@ namespace gadt
 			static const AgentIndex _no_winner_index = 0;
 			static const size_t		_default_policy_warning_length = 1000;
 
+			//win time of excluded child in the selection kernel, which makes its value the lowest.
+			static constexpr float	_excluded_win_time = -1e30f;
+
 			//exist unactived action in the action set.
 			inline bool exist_unactivated_action() const
 			{
@@ -226,6 +477,145 @@ namespace gadt
 				_child_nodes[_next_action_index] = ptr;
 			}
 
+			//copy the statistics of child node to the contiguous arrays.
+			inline void update_child_value(size_t index)
+			{
+				_child_visited_time[index] = static_cast<float>(_child_nodes[index]->visited_time());
+				_child_win_time[index] = static_cast<float>(_child_nodes[index]->win_time());
+			}
+
+			//initialize the AMAF statistics when the node is visited with RAVE enabled at the first time.
+			void init_amaf(const FuncPackage& func, gadt::stl::ArenaAllocator& arena)
+			{
+				_action_keys.assign(arena, _action_set.size(), 0);
+				for (size_t i = 0; i < _action_keys.size(); i++)
+				{
+					_action_keys[i] = func.ActionToKey(_action_set[i]);
+				}
+
+				//each action starts with one virtual visit of half win.
+				_child_amaf_visited_time.assign(arena, _action_set.size(), 1);
+				_child_amaf_win_time.assign(arena, _action_set.size(), 0.5f);
+			}
+
+			//update AMAF statistics of all actions that are played by the player of this node, whose actions are at the ply.
+			void update_amaf(const AmafRecord& amaf, bool is_win, size_t ply)
+			{
+				for (size_t i = 0; i < _action_keys.size(); i++)
+				{
+					if (amaf.exist(_action_keys[i], ply))
+					{
+						_child_amaf_visited_time[i] += 1;
+						if (is_win)
+						{
+							_child_amaf_win_time[i] += 1;
+						}
+					}
+				}
+			}
+
+			//prove the terminal node by its result.
+			void prove_end_state(const Result& result, const FuncPackage& func)
+			{
+				if (func.AllowUpdateValue(_state, result))
+				{
+					_proven_value = PROVEN_WIN;
+				}
+				else if (!func.ResultIsDraw || !func.ResultIsDraw(result))
+				{
+					_proven_value = PROVEN_LOSS;
+				}
+				_proven_result = result;
+			}
+
+			//update proven value after the child was searched, the child would be excluded from selection if it is proven loss.
+			void update_proven_value(size_t index, ProvenValue prev_child_value)
+			{
+				const Node* child = _child_nodes[index];
+				if (child->_proven_value == PROVEN_WIN)
+				{
+					//the player of this node could win by choosing this child.
+					_proven_value = PROVEN_LOSS;
+					_proven_result = child->_proven_result;
+				}
+				else if (child->_proven_value == PROVEN_LOSS && prev_child_value != PROVEN_LOSS)
+				{
+					_proven_loss_child++;
+					_child_win_time[index] = _excluded_win_time;
+					if (_proven_loss_child == _action_set.size())
+					{
+						//all the children lose.
+						_proven_value = PROVEN_WIN;
+						_proven_result = child->_proven_result;
+					}
+				}
+			}
+
+			//sample the index of an outcome of the chance state by the weights of outcomes.
+			static size_t SampleOutcome(const FuncPackage& func, const State& state, const ActionSet& outcomes)
+			{
+				size_t total_weight = 0;
+				for (const Action& outcome : outcomes)
+				{
+					total_weight += func.ChanceWeight(state, outcome);
+				}
+				size_t rnd = gadt::random::RandomIndex(total_weight);
+				for (size_t i = 0; i < outcomes.size(); i++)
+				{
+					const size_t weight = func.ChanceWeight(state, outcomes[i]);
+					if (rnd < weight)
+					{
+						return i;
+					}
+					rnd -= weight;
+				}
+				return outcomes.size() - 1;
+			}
+
+			//get the index of child node that would be selected by tree policy.
+			size_t select_child_index(const FuncPackage& func, const MctsSetting& setting) const
+			{
+				if (!func.TreePolicyValue)
+				{
+					if (!_action_keys.empty())
+					{
+						return policy::RaveUCB1Select(
+							_child_win_time.data(),
+							_child_visited_time.data(),
+							_child_amaf_win_time.data(),
+							_child_amaf_visited_time.data(),
+							_child_nodes.size(),
+							policy::UCB1ParentTerm(_visited_time),
+							setting.ucb_exploration,
+							setting.rave_equivalence
+						);
+					}
+					return policy::UCB1Select(
+						_child_win_time.data(),
+						_child_visited_time.data(),
+						_child_nodes.size(),
+						policy::UCB1ParentTerm(_visited_time),
+						setting.ucb_exploration
+					);
+				}
+
+				size_t max_ucb_index = 0;
+				UcbValue max_ucb_value = 0;
+				for (size_t i = 0; i < _child_nodes.size(); i++)
+				{
+					if (_child_nodes[i] != nullptr && _child_nodes[i]->_proven_value != PROVEN_LOSS)
+					{
+						UcbValue child_node_ucb_value = func.TreePolicyValue(*this, *_child_nodes[i]);
+						if (child_node_ucb_value > max_ucb_value)
+						{
+							max_ucb_index = i;
+							max_ucb_value = child_node_ucb_value;
+						}
+					}
+				}
+				return max_ucb_index;
+			}
+
 			//move the cursor to next action.
 			inline void to_next_action()
 			{
@@ -244,7 +634,43 @@ namespace gadt
 				_win_time++;
 			}
 
-			//free the node from allocator.
+		public:
+			MctsNode(const State& state, const FuncPackage& func, Allocator& allocator) :
+				_state(state),
+				_winner_index(func.DetemineWinner(state)),
+				_is_chance(func.IsChanceState && func.IsChanceState(state)),
+				_visited_time(1),
+				_win_time(0),
+				_next_action_index(0),
+				_proven_value(NOT_PROVEN),
+				_proven_loss_child(0),
+				_proven_result()
+			{
+				if (!is_end_state())
+				{
+					ActionSet& actions = allocator.action_buffer();
+					actions.clear();
+					func.MakeAction(_state, actions);
+					_action_set.assign(allocator.arena(), actions.begin(), actions.end());
+					_child_nodes.assign(allocator.arena(), _action_set.size(), nullptr);
+					_child_visited_time.assign(allocator.arena(), _action_set.size(), 1);
+					_child_win_time.assign(allocator.arena(), _action_set.size(), 0);
+					if (_is_chance)
+					{
+						size_t total_weight = 0;
+						_outcome_weight.assign(allocator.arena(), _action_set.size(), 0);
+						for (size_t i = 0; i < _outcome_weight.size(); i++)
+						{
+							total_weight += func.ChanceWeight(_state, _action_set[i]);
+							_outcome_weight[i] = total_weight;
+						}
+					}
+				}
+			}
+
+			MctsNode(const MctsNode&) = delete;
+
+			//free the node from allocator, the arrays of the nodes are kept in the arena until the allocator is flushed.
 			void FreeFromAllocator(Allocator& allocator)
 			{
 				//free all child node if possible.
@@ -259,32 +685,15 @@ namespace gadt
 				//free the node itself.
 				if (is_debug())
 				{
-					bool b = allocator.free(this);
+					bool b = allocator.destory(this);
 					GADT_CHECK_WARNING(g_MCTS_NEW_ENABLE_WARNING, b == false, "MCTS105: free child node failed.");
 				}
 				else
 				{
-					allocator.free(this);
-				}
-			}
-
-		public:
-			MctsNode(const State& state, const FuncPackage& func) :
-				_state(state),
-				_winner_index(func.DetemineWinner(state)),
-				_visited_time(1),
-				_win_time(0),
-				_next_action_index(0)
-			{
-				if (!is_end_state())
-				{
-					func.MakeAction(_state, _action_set);
-					_child_nodes.resize(_action_set.size(), nullptr);
+					allocator.destory(this);
 				}
 			}
 
-			MctsNode(const MctsNode&) = delete;
-
 			//TODO
 			//TODO
 			//TODO free child node from allocator by index. return true if free successfully.
@@ -304,7 +713,9 @@ namespace gadt
 			}
 
 			//3.simulation is run from the new node according to the default policy to produce a result.
-			void SimulationProcess(Result& result, const FuncPackage& func)
+			//the keys of actions in the simulation would be added to amaf if it is not nullptr, ply is the ply of this node.
+			//outcomes of chance are sampled by weights, they are not counted as plies since the player is not changed.
+			void SimulationProcess(Result& result, const FuncPackage& func, AmafRecord* amaf, size_t ply)
 			{
 				State state = _state;	//copy
 				ActionSet actions;
@@ -318,8 +729,25 @@ namespace gadt
 						break;
 					}
 					actions.clear();
+					if (func.IsChanceState && func.IsChanceState(state))
+					{
+						func.MakeAction(state, actions);
+						state = func.GetNewState(state, actions[SampleOutcome(func, state, actions)]);
+						continue;
+					}
+
+					//the simulation function replaces the playout, so no action is added to amaf.
+					if (func.Simulation)
+					{
+						result = func.Simulation(state);
+						break;
+					}
 					func.MakeAction(state, actions);
 					const Action& action = func.DefaultPolicy(actions);
+					if (amaf != nullptr)
+					{
+						amaf->add(func.ActionToKey(action), ply++);
+					}
 					state = func.GetNewState(state, action);
 				}
 
@@ -327,7 +755,7 @@ namespace gadt
 			}
 
 			//2.one child node would be added to expand the tree, acccording to the available actions.
-			void Expandsion(Result& result, Allocator& allocator ,const FuncPackage& func)
+			void Expandsion(Result& result, Allocator& allocator, const FuncPackage& func, const MctsSetting& setting, AmafRecord* amaf, size_t ply)
 			{
 				if (is_end_state())
 				{
@@ -338,45 +766,89 @@ namespace gadt
 				{
 					Node* new_node = allocator.construct(func.GetNewState(_state, next_action()),func);
 					set_next_child(new_node);
+					new_node->SimulationProcess(result, func, amaf, ply + 1);
+					update_child_value(_next_action_index);
+					if (setting.solver_enabled && new_node->is_end_state())
+					{
+						new_node->prove_end_state(result, func);
+						update_proven_value(_next_action_index, NOT_PROVEN);
+					}
+					if (amaf != nullptr)
+					{
+						amaf->add(_action_keys[_next_action_index], ply);
+						update_amaf(*amaf, new_node->win_time() != 0, ply);
+					}
 					to_next_action();
-					new_node->SimulationProcess(result, func);
 				}
 			}
 
+			//select an outcome of the chance node by its weight, the outcome is expanded at its first selection.
+			//the outcome does not change the player, so it is at the same ply as the chance node.
+			void ChanceSelection(Result& result, Allocator& allocator, const FuncPackage& func, const MctsSetting& setting, AmafRecord* amaf, size_t ply)
+			{
+				const size_t index = std::upper_bound(_outcome_weight.begin(), _outcome_weight.end(), gadt::random::RandomIndex(_outcome_weight.back())) - _outcome_weight.begin();
+				Node* outcome_node = _child_nodes[index];
+				if (outcome_node == nullptr)
+				{
+					outcome_node = allocator.construct(func.GetNewState(_state, _action_set[index]), func);
+					_child_nodes[index] = outcome_node;
+					outcome_node->SimulationProcess(result, func, amaf, ply);
+				}
+				else
+				{
+					outcome_node->Selection(result, allocator, func, setting, amaf, ply);
+				}
+				update_child_value(index);
+			}
+
 			//1. select the most urgent expandable node,and get the result to update statistic.
-			void Selection(Result& result, Allocator& allocator,const FuncPackage& func)
+			//amaf is the record of actions after this node, which is nullptr if RAVE is disabled. ply is the depth of this node.
+			void Selection(Result& result, Allocator& allocator, const FuncPackage& func, const MctsSetting& setting, AmafRecord* amaf, size_t ply = 0)
 			{
 				incr_visited_time();
 
 				if (is_end_state())
 				{
-					func.StateToResult(_state, result);
+					result = func.StateToResult(_state, _winner_index);
+				}
+				else if (_proven_value != NOT_PROVEN)
+				{
+					result = _proven_result;	//the outcome is known, no more search is needed.
+				}
+				else if (_is_chance)
+				{
+					ChanceSelection(result, allocator, func, setting, amaf, ply);
 				}
 				else
 				{
+					if (amaf != nullptr && _action_keys.empty())
+					{
+						init_amaf(func, allocator.arena());
+					}
+
 					if (exist_unactivated_action())
 					{
-						Expandsion(result, allocator, func);
+						Expandsion(result, allocator, func, setting, amaf, ply);
 					}
 					else
 					{
 						if (is_debug()) { GADT_CHECK_WARNING(g_MCTS_NEW_ENABLE_WARNING, _child_nodes.size() == 0, "MCTS106: empty action set during tree policy."); }
-						Node* max_ucb_child_node = _child_nodes[0];
-						UcbValue max_ucb_value = 0;
-						for (size_t i = 0; i < _child_nodes.size(); i++)
+						size_t max_ucb_index = select_child_index(func, setting);
+						Node* max_ucb_child_node = _child_nodes[max_ucb_index];
+						if (is_debug()) { GADT_CHECK_WARNING(g_MCTS_NEW_ENABLE_WARNING, max_ucb_child_node == nullptr, "MCTS108: best child node pointer is nullptr."); }
+						uint32_t child_win_time = max_ucb_child_node->win_time();
+						ProvenValue child_proven_value = max_ucb_child_node->proven_value();
+						max_ucb_child_node->Selection(result, allocator, func, setting, amaf, ply + 1);
+						update_child_value(max_ucb_index);
+						if (setting.solver_enabled)
 						{
-							if (_child_nodes[i] != nullptr)
-							{
-								UcbValue child_node_ucb_value = func.TreePolicyValue(*this, *_child_nodes[i]);
-								if (child_node_ucb_value > max_ucb_value)
-								{
-									max_ucb_child_node = _child_nodes[i];
-									max_ucb_value = child_node_ucb_value;
-								}
-							}
+							update_proven_value(max_ucb_index, child_proven_value);
+						}
+						if (amaf != nullptr)
+						{
+							amaf->add(_action_keys[max_ucb_index], ply);
+							update_amaf(*amaf, max_ucb_child_node->win_time() != child_win_time, ply);
 						}
-						if (is_debug()) { GADT_CHECK_WARNING(g_MCTS_NEW_ENABLE_WARNING, max_ucb_child_node == nullptr, "MCTS108: best child node pointer is nullptr."); }
-						max_ucb_child_node->Selection(result, allocator, func);
 					}
 				}
 
@@ -395,7 +867,7 @@ namespace gadt
 			{
 				std::stringstream ss;
 				double avg = static_cast<double>(win_time()) / static_cast<double>(visited_time());
-				ss << "{ visited:" << visited_time() << " win:" << win_time() <<" avg:" << avg << " child";
+				ss << "{ visited:" << visited_time() << " win:" << win_time() <<" avg:" << avg << " proven:" << (int)proven_value() << " child";
 				if (exist_unactivated_action())
 				{
 					ss << next_action_index() << "/" << action_set().size();
@@ -415,6 +887,89 @@ namespace gadt
 			}
 		};
 
+		/*
+		* MctsAllocator is the allocator of MctsNode, which keeps the nodes in a pool and the arrays of the nodes in an arena.
+		*
+		* flush discards all the trees in the allocator at once, it is O(1) if State, Action and Result are trivially destructible.
+		*
+		* [State] is the game-state class, which is defined by the user.
+		* [Action] is the game-action class, which is defined by the user.
+		* [Result] is the game-result class, which stand for a terminal state of the game.
+		* [is_debug] means some debug info would not be ignored if it is true. this may result in a little degradation of performance.
+		*/
+		template<typename State, typename Action, typename Result, bool _is_debug>
+		class MctsAllocator
+		{
+		public:
+			using Node			= MctsNode<State, Action, Result, _is_debug>;
+			using ActionSet		= typename Node::ActionSet;
+			using FuncPackage	= typename Node::FuncPackage;
+
+		private:
+			static const size_t _arena_chunk_size = 1 << 20;
+
+			gadt::stl::PoolAllocator<Node, _is_debug>	_node_pool;		//pool of nodes.
+			gadt::stl::ArenaAllocator					_arena;			//arrays of nodes.
+			ActionSet									_action_buffer;	//buffer of actions when a node is created.
+
+		public:
+			//constructor function with the max node count.
+			MctsAllocator(size_t max_node, bool huge_page = false) :
+				_node_pool(max_node, huge_page),
+				_arena(_arena_chunk_size),
+				_action_buffer()
+			{
+			}
+
+			//copy constructor is banned.
+			MctsAllocator(const MctsAllocator&) = delete;
+
+			//create a node of the state, return nullptr if the pool is full.
+			inline Node* construct(const State& state, const FuncPackage& func)
+			{
+				return _node_pool.construct(state, func, *this);
+			}
+
+			//free a node, its arrays are kept in the arena until flush.
+			inline bool destory(Node* node)
+			{
+				return _node_pool.destory(node);
+			}
+
+			//discard all the nodes and their arrays.
+			inline void flush()
+			{
+				_node_pool.flush();
+				_arena.flush();
+			}
+
+			//get the arena of the arrays in nodes.
+			inline gadt::stl::ArenaAllocator& arena()
+			{
+				return _arena;
+			}
+
+			//get the buffer that is filled by MakeAction when a node is created.
+			inline ActionSet& action_buffer()
+			{
+				return _action_buffer;
+			}
+
+			inline size_t total_size()	const { return _node_pool.total_size(); }
+			inline size_t remain_size()	const { return _node_pool.remain_size(); }
+			inline size_t size()		const { return _node_pool.size(); }
+			inline bool is_full()		const { return _node_pool.is_full(); }
+			inline bool is_empty()		const { return _node_pool.is_empty(); }
+
+			//get info as string format
+			inline std::string info() const
+			{
+				std::stringstream ss;
+				ss << "{nodes: " << _node_pool.info() << ", arena: " << _arena.info() << "}";
+				return ss.str();
+			}
+		};
+
 		/*
 		* MctsToJson is used for convert mcts search tree to json tree.
 		*
@@ -527,6 +1082,7 @@ namespace gadt
 			FuncPackage		_func_package;			//function package of the search.
 			MctsSetting		_setting;				//mcts setting.
 			LogController	_log_controller;		//controller of the logs.
+			AmafRecord		_amaf_record;			//record of actions in current iteration, used by RAVE.
 			Allocator&		_allocator;				//the allocator for the search.
 			const bool		_private_allocator;		//use private allocator.
 
@@ -552,6 +1108,10 @@ namespace gadt
 					<< "    timeout: " << _setting.timeout << std::endl
 					<< "    max_iteration: " << _setting.max_iteration << std::endl
 					<< "    enable_gc: " << _setting.gc_enabled << std::endl
+					<< "    ucb_exploration: " << _setting.ucb_exploration << std::endl
+					<< "    rave_enabled: " << rave_enabled() << std::endl
+					<< "    rave_equivalence: " << _setting.rave_equivalence << std::endl
+					<< "    solver_enabled: " << _setting.solver_enabled << std::endl
 					<< "}" << std::endl;
 				return ss.str();
 			}
@@ -574,6 +1134,12 @@ namespace gadt
 				return _log_controller.json_output_enabled();
 			}
 
+			//return true if RAVE is enabled and the key function is set.
+			inline bool rave_enabled() const
+			{
+				return _setting.rave_enabled && _func_package.ActionToKey;
+			}
+
 			//define functions as default.
 			DefaultFuncPackage DefaultFuncInit()
 			{
@@ -586,7 +1152,7 @@ namespace gadt
 					{
 						GADT_CHECK_WARNING(g_MCTS_NEW_ENABLE_WARNING, actions.size() == 0, "MCTS104: empty action set during default policy.");
 					}
-					return actions[rand() % actions.size()];
+					return actions[gadt::random::RandomIndex(actions.size())];
 				};
 				auto AllowExtend = [](const Node& node)->bool {
 					return true; 
@@ -613,7 +1179,7 @@ namespace gadt
 			//function package initilize.
 			void FuncInit()
 			{
-				_func_package.TreePolicyValue	= DefaultFunc.TreePolicyValue;
+				_func_package.TreePolicyValue	= nullptr;	//use vectorized UCB1 kernel, which is equal to DefaultFunc.TreePolicyValue.
 				_func_package.DefaultPolicy		= DefaultFunc.DefaultPolicy;
 				_func_package.AllowExtend		= DefaultFunc.AllowExtend;
 				_func_package.AllowExcuteGc		= DefaultFunc.AllowExcuteGc;
@@ -629,14 +1195,15 @@ namespace gadt
 						  << "[MCTS] info = " << info() << std::endl;
 				}
 
+				const bool own_allocator = _private_allocator || _allocator.is_empty();	//the tree is the only user of the allocator.
 				Node* root_node = _allocator.construct(root_state, _func_package);
-				ActionSet root_actions = root_node->action_set();
-				timer::TimePoint start_tp;
+				ActionSet root_actions(root_node->action_set().begin(), root_node->action_set().end());
+				timer::Deadline deadline(_setting.timeout);
 				size_t iteration_time = 0;
 				for (iteration_time = 0; iteration_time < _setting.max_iteration; iteration_time++)
 				{
-					//stop search if timout.
-					if (start_tp.time_since_created() > _setting.timeout && is_debug() == false)
+					//stop search if timout, the clock is polled every few iterations.
+					if (deadline.poll_timeout() && is_debug() == false)
 					{
 						break;//timeout, stop search.
 					}
@@ -661,7 +1228,19 @@ namespace gadt
 
 					//excute next.
 					Result new_result;
-					root_node->Selection(new_result, _allocator, _func_package);
+					AmafRecord* amaf = nullptr;
+					if (rave_enabled())
+					{
+						_amaf_record.clear();
+						amaf = &_amaf_record;
+					}
+					root_node->Selection(new_result, _allocator, _func_package, _setting, amaf);
+
+					//stop search if the value of root is proven.
+					if (root_node->proven_value() != NOT_PROVEN)
+					{
+						break;
+					}
 				}
 
 				//return the best result
@@ -674,6 +1253,7 @@ namespace gadt
 				if (log_enabled())
 				{
 					logger() << "[MCTS] iteration finished." << std::endl
+						<< "[MCTS] iteration = " << iteration_time << ", time = " << deadline.time_since_created() << "s" << std::endl
 						<< "[MCTS] actions = {" << std::endl;
 				}
 
@@ -698,6 +1278,14 @@ namespace gadt
 					if (child_ptr != nullptr)
 					{
 						UcbValue child_value = _func_package.ValueForRootNode(*child_ptr);
+						if (child_ptr->proven_value() == PROVEN_WIN)
+						{
+							child_value = std::numeric_limits<UcbValue>::max();	//proven win is always the best choice.
+						}
+						else if (child_ptr->proven_value() == PROVEN_LOSS)
+						{
+							child_value = 0;
+						}
 						if (child_value > max_value)
 						{
 							max_value = child_value;
@@ -721,6 +1309,16 @@ namespace gadt
 					GADT_CHECK_WARNING(g_MCTS_NEW_ENABLE_WARNING, root_actions.size() == 0, "MCTS102: best value for root node equal to 0."); 
 				}
 
+				//discard the search tree, the allocator is reset at once if no other tree is in it.
+				if (own_allocator)
+				{
+					_allocator.flush();
+				}
+				else
+				{
+					root_node->FreeFromAllocator(_allocator);
+				}
+
 				return root_actions[max_value_node_index];
 			}
 
@@ -755,7 +1353,7 @@ namespace gadt
 				typename FuncPackage::DetemineWinnerFunc	_DetemineWinner,
 				typename FuncPackage::StateToResultFunc		_StateToResult,
 				typename FuncPackage::AllowUpdateValueFunc	_AllowUpdateValue,
-				Allocator allocator
+				Allocator& allocator
 			):
 				_func_package(
 					_GetNewState,
@@ -794,6 +1392,33 @@ namespace gadt
 				return ExcuteMCTS(root_state);
 			}
 
+			//set the function that get the key of action, which is necessary for RAVE.
+			inline void InitRave(typename FuncPackage::ActionToKeyFunc _action_to_key)
+			{
+				_func_package.ActionToKey = _action_to_key;
+			}
+
+			//set the function that judge whether a result is draw, which is used by MCTS-Solver.
+			//the solver assumes two players taking turns with no chance nodes inside the tree.
+			inline void InitSolver(typename FuncPackage::ResultIsDrawFunc _result_is_draw)
+			{
+				_func_package.ResultIsDraw = _result_is_draw;
+			}
+
+			//set the functions of chance, each chance state is a chance node whose outcome is sampled by weight in each iteration.
+			//chance nodes are never proven, and the root state should not be a chance state.
+			inline void InitChance(typename FuncPackage::IsChanceStateFunc _is_chance_state, typename FuncPackage::ChanceWeightFunc _chance_weight)
+			{
+				_func_package.IsChanceState = _is_chance_state;
+				_func_package.ChanceWeight = _chance_weight;
+			}
+
+			//set the function that replaces the default policy playout by the result of a state.
+			inline void InitSimulation(typename FuncPackage::SimulationFunc _simulation)
+			{
+				_func_package.Simulation = _simulation;
+			}
+
 			//enable log output to ostream.
 			inline void InitLog(
 				typename LogController::StateToStrFunc     _state_to_str,
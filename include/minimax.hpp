@@ -54,13 +54,24 @@ namespace gadt
 			bool ab_prune_enabled;
 			AgentIndex no_winner_index;	//the index of no winner
 			EvalValue original_eval; //original evale value.
+			EvalValue eval_lower_bound;	//lower bound of all evals, used by Star1/Star2 pruning in expectimax.
+			EvalValue eval_upper_bound;	//upper bound of all evals, used by Star1/Star2 pruning in expectimax.
+			size_t thread_count;		//the number of threads in alpha-beta search.
+			size_t quiescence_depth;	//max depth of quiescence search at leaves, quiescence search is disabled if it is 0.
+			EvalValue delta_margin;		//margin of delta pruning in quiescence search.
 
 			//default setting constructor.
 			MinimaxSetting() :
 				timeout(30),
 				max_depth(10),
 				ab_prune_enabled(false),
-				no_winner_index(0)
+				no_winner_index(0),
+				original_eval(0),
+				eval_lower_bound(-std::numeric_limits<EvalValue>::infinity()),
+				eval_upper_bound(std::numeric_limits<EvalValue>::infinity()),
+				thread_count(1),
+				quiescence_depth(8),
+				delta_margin(0)
 			{
 			}
 
@@ -70,14 +81,211 @@ namespace gadt
 				size_t _max_depth, 
 				bool _ab_prune_enabled, 
 				AgentIndex _no_winner_index = 0, 
-				EvalValue _original_eval = 0
+				EvalValue _original_eval = 0,
+				EvalValue _eval_lower_bound = -std::numeric_limits<EvalValue>::infinity(),
+				EvalValue _eval_upper_bound = std::numeric_limits<EvalValue>::infinity(),
+				size_t _thread_count = 1,
+				size_t _quiescence_depth = 8,
+				EvalValue _delta_margin = 0
 			) :
 				timeout(_timeout),
 				max_depth(_max_depth),
 				ab_prune_enabled(_ab_prune_enabled),
-				no_winner_index(_no_winner_index)
+				no_winner_index(_no_winner_index),
+				original_eval(_original_eval),
+				eval_lower_bound(_eval_lower_bound),
+				eval_upper_bound(_eval_upper_bound),
+				thread_count(_thread_count),
+				quiescence_depth(_quiescence_depth),
+				delta_margin(_delta_margin)
 			{
 			}
+
+			//return true if evals are bounded, which is necessary for Star1/Star2 pruning.
+			inline bool eval_bounded() const
+			{
+				return std::isfinite(eval_lower_bound) && std::isfinite(eval_upper_bound);
+			}
+		};
+
+		//type of the value saved in transposition table.
+		enum BoundType : uint8_t
+		{
+			NO_BOUND = 0,		//empty entry.
+			EXACT_BOUND = 1,	//the value is exact.
+			LOWER_BOUND = 2,	//the value is a lower bound, which is caused by a cut off.
+			UPPER_BOUND = 3		//the value is an upper bound, which means all actions fail low.
+		};
+
+		/*
+		* TranspositionEntry is the entry of transposition table.
+		*
+		* value is from the view of the player who take action in the state.
+		*/
+		struct TranspositionEntry
+		{
+			uint64_t	key;		//hash of the state.
+			EvalValue	value;		//value of the state.
+			uint16_t	depth;		//remaining depth of the search.
+			BoundType	bound;		//type of the value.
+			uint8_t		age;		//age of the search that saved the entry.
+			uint32_t	best_index;	//index of best action.
+		};
+
+		/*
+		* TranspositionTable is a fixed size hash table which saves the search results of states.
+		*
+		* the number of entries is the largest power of two that fits in the memory size.
+		* an entry is replaced if it comes from an older search or the new result is searched deeper.
+		* the table is lock-free and can be shared by threads. each slot saves the key xor the other words,
+		* so a slot torn by concurrent writes fails the key check and is treated as a miss.
+		*/
+		class TranspositionTable
+		{
+		public:
+			using Entry = TranspositionEntry;
+
+		private:
+			struct Slot
+			{
+				std::atomic<uint64_t> check;	//key ^ value ^ data.
+				std::atomic<uint64_t> value;	//bits of value.
+				std::atomic<uint64_t> data;		//depth, bound, age and best index.
+			};
+
+			std::unique_ptr<Slot[]>	_slots;
+			size_t					_size;
+			uint64_t				_mask;		//mask to get index from key.
+			uint8_t					_age;		//age of current search.
+
+		private:
+			//pack depth, bound, age and best index to a word.
+			static inline uint64_t pack_data(size_t depth, BoundType bound, uint8_t age, size_t best_index)
+			{
+				return uint64_t(uint16_t(depth)) | (uint64_t(bound) << 16) | (uint64_t(age) << 24) | (uint64_t(uint32_t(best_index)) << 32);
+			}
+
+			//convert value to bits.
+			static inline uint64_t value_to_bits(EvalValue value)
+			{
+				uint64_t bits;
+				memcpy(&bits, &value, sizeof(bits));
+				return bits;
+			}
+
+			//convert bits to value.
+			static inline EvalValue bits_to_value(uint64_t bits)
+			{
+				EvalValue value;
+				memcpy(&value, &bits, sizeof(value));
+				return value;
+			}
+
+		public:
+			//create table by memory size in MB, the table is disabled if the size is 0.
+			TranspositionTable(size_t memory_mb = 0) :
+				_slots(),
+				_size(0),
+				_mask(0),
+				_age(0)
+			{
+				resize(memory_mb);
+			}
+
+			//resize the table by memory size in MB, all entries would be cleared.
+			void resize(size_t memory_mb)
+			{
+				size_t max_count = memory_mb * 1024 * 1024 / sizeof(Slot);
+				size_t count = 0;
+				if (max_count > 0)
+				{
+					count = 1;
+					while (count * 2 <= max_count) { count *= 2; }
+				}
+				_slots.reset(count == 0 ? nullptr : new Slot[count]);
+				_size = count;
+				_mask = count == 0 ? 0 : count - 1;
+				clear();
+			}
+
+			//clear all entries, which must not be called while searching.
+			void clear()
+			{
+				for (size_t i = 0; i < _size; i++)
+				{
+					_slots[i].check.store(0, std::memory_order_relaxed);
+					_slots[i].value.store(0, std::memory_order_relaxed);
+					_slots[i].data.store(0, std::memory_order_relaxed);
+				}
+				_age = 0;
+			}
+
+			//start a new search, entries from previous searches are prior to be replaced.
+			inline void new_search()
+			{
+				_age++;
+			}
+
+			//return true if the table is enabled.
+			inline bool enabled() const
+			{
+				return _size != 0;
+			}
+
+			//get entry by key, return false if not found.
+			inline bool probe(uint64_t key, Entry& entry) const
+			{
+				const Slot& slot = _slots[key & _mask];
+				const uint64_t data = slot.data.load(std::memory_order_relaxed);
+				const uint64_t value = slot.value.load(std::memory_order_relaxed);
+				const uint64_t check = slot.check.load(std::memory_order_relaxed);
+				const BoundType bound = BoundType((data >> 16) & 0xFF);
+				if (bound == NO_BOUND || (check ^ value ^ data) != key)
+				{
+					return false;
+				}
+				entry.key = key;
+				entry.value = bits_to_value(value);
+				entry.depth = uint16_t(data & 0xFFFF);
+				entry.bound = bound;
+				entry.age = uint8_t((data >> 24) & 0xFF);
+				entry.best_index = uint32_t(data >> 32);
+				return true;
+			}
+
+			//save the search result of a state.
+			inline void store(uint64_t key, EvalValue value, size_t depth, BoundType bound, size_t best_index)
+			{
+				Slot& slot = _slots[key & _mask];
+				const uint64_t old_data = slot.data.load(std::memory_order_relaxed);
+				const uint64_t old_check = slot.check.load(std::memory_order_relaxed);
+				const uint64_t old_value = slot.value.load(std::memory_order_relaxed);
+				const BoundType old_bound = BoundType((old_data >> 16) & 0xFF);
+				const uint8_t old_age = uint8_t((old_data >> 24) & 0xFF);
+				const size_t old_depth = size_t(old_data & 0xFFFF);
+				if (old_bound == NO_BOUND || old_age != _age || (old_check ^ old_value ^ old_data) == key || depth >= old_depth)
+				{
+					const uint64_t data = pack_data(depth, bound, _age, best_index);
+					const uint64_t bits = value_to_bits(value);
+					slot.value.store(bits, std::memory_order_relaxed);
+					slot.data.store(data, std::memory_order_relaxed);
+					slot.check.store(key ^ bits ^ data, std::memory_order_relaxed);
+				}
+			}
+
+			//get the number of entries.
+			inline size_t size() const
+			{
+				return _size;
+			}
+
+			//get info as string format
+			inline std::string info() const
+			{
+				std::stringstream ss;
+				ss << "{entries: " << _size << "}";
+				return ss.str();
+			}
 		};
 
 		/*
@@ -103,6 +311,13 @@ namespace gadt
 				using MakeActionFunc = std::function<void(const State&, ActionSet&)>;
 				using DetemineWinnerFunc = std::function<AgentIndex(const State&)>;
 				using EvalForParentFunc = std::function<EvalValue(const State&, const AgentIndex)>;
+				using ActionPriorityFunc = std::function<EvalValue(const State&, const Action&, size_t)>;
+				using RecordCutoffFunc = std::function<void(const State&, const Action&, size_t, size_t)>;
+				using StateHashFunc = std::function<uint64_t(const State&)>;
+				using ApplyActionFunc = std::function<void(State&, const Action&)>;
+				using UndoActionFunc = std::function<void(State&, const Action&)>;
+				using MakeQuiescenceActionFunc = std::function<void(const State&, ActionSet&)>;
+				using ActionGainFunc = std::function<EvalValue(const State&, const Action&)>;
 
 			public:
 				//necessary functions.
@@ -111,6 +326,15 @@ namespace gadt
 				const DetemineWinnerFunc	DetemineWinner;		//return no_winner_index if a state is not terminal state.
 				const EvalForParentFunc		EvalForParent;		//get the eval for parent node.
 
+				//optional functions.
+				ActionPriorityFunc			ActionPriority;		//get the priority of an action at a ply for move ordering, actions with higher priority are searched first.
+				RecordCutoffFunc			RecordCutoff;		//record the action that causes a cut off at a ply with remaining depth, such as killer moves and history.
+				StateHashFunc				StateHash;			//get the hash of a state, which is necessary for transposition table.
+				ApplyActionFunc				ApplyAction;		//change the state by action in place, GetNewState is used if it is empty.
+				UndoActionFunc				UndoAction;			//restore the state changed by ApplyAction.
+				MakeQuiescenceActionFunc	MakeQuiescenceAction;//create the set of noisy actions such as captures, which enables quiescence search at leaves.
+				ActionGainFunc				ActionGain;			//get the max gain of eval by an action, which enables delta pruning in quiescence search.
+
 			public:
 				FuncPackage(
 					GetNewStateFunc			_GetNewState,
@@ -203,6 +427,14 @@ namespace gadt
 		/*
 		* MinimaxSearch is a template of Minimax search.
 		*
+		* nodes are not created during the search. states and actions of each ply are kept in stacks which are allocated
+		* before the search, so State must be copy assignable. if ApplyAction and UndoAction are set by InitInPlace,
+		* a single state is changed in place instead of copying states.
+		*
+		* alpha-beta search runs in Lazy SMP mode if thread_count in setting is more than 1. all threads search the same root
+		* and share the transposition table, helper threads start from different depths and root orders, and the deepest
+		* completed result is returned. functions in FuncPackage must be thread-safe and MakeAction must be deterministic in this mode.
+		*
 		* [State] is the game-state class, which is defined by the user.
 		* [Action] is the game-action class, which is defined by the user.
 		* [_is_debug] means some debug info would not be ignored if it is true. this may result in a little degradation of performance.
@@ -219,10 +451,56 @@ namespace gadt
 			using VisualNodePtr	= visual_tree::VisualNode*;
 			
 		private:
-			
+			//search frame of a ply, which is reused by all the nodes in the ply.
+			struct PlyFrame
+			{
+				ActionSet				actions;	//actions of the node.
+				std::vector<size_t>		order;		//search order of actions.
+				std::vector<EvalValue>	priority;	//priority of actions for move ordering.
+			};
+
+			//data of a search thread, memory is allocated when the search starts and reused later.
+			struct SearchWorker
+			{
+				size_t								index;				//index of the worker, 0 is the main thread.
+				bool								json_enabled;		//only the main thread outputs json.
+				std::vector<State>					state_stack;		//states of nodes in each ply, only the first one is used if states are changed in place.
+				std::vector<PlyFrame>				frames;				//frames of nodes in each ply.
+				std::vector<std::vector<size_t>>	pv_table;			//triangular table of principal variation, saved as indexes of actions in each ply.
+				std::vector<size_t>					prev_pv;			//principal variation of last completed iteration.
+				timer::Deadline						deadline;			//deadline of current search.
+				bool								aborted;			//current iteration is aborted.
+				size_t								node_count;			//the number of visited nodes.
+				size_t								leaf_node_count;	//the number of evaluated leaf nodes.
+				size_t								tt_hit_count;		//the number of transposition table hits.
+				size_t								completed_depth;	//the depth of last completed iteration.
+				size_t								best_action_index;	//best action of last completed iteration.
+				std::vector<EvalValue>				eval_set;			//evals of root actions in last completed iteration.
+
+				SearchWorker(size_t _index) :
+					index(_index),
+					json_enabled(false),
+					deadline(0),
+					aborted(false),
+					node_count(0),
+					leaf_node_count(0),
+					tt_hit_count(0),
+					completed_depth(0),
+					best_action_index(0)
+				{
+				}
+			};
+
+			static const size_t		_no_pv_index = std::numeric_limits<size_t>::max();
+
 			FuncPackage		_func;
 			MinimaxSetting	_setting;
 			LogController	_log_controller;
+			size_t			_node_count;		//the number of nodes visited in last search.
+			size_t			_leaf_node_count;	//the number of leaf nodes evaluated in last search.
+			TranspositionTable	_tt;			//transposition table, which is shared by searches and threads.
+			std::vector<std::unique_ptr<SearchWorker>>	_workers;	//workers of threads, the first one is used by single thread search.
+			std::atomic<bool>	_stop;			//stop all threads.
 
 		private:
 
@@ -240,6 +518,10 @@ namespace gadt
 					<< "    timeout: " << _setting.timeout << std::endl
 					<< "    max_depth: " << _setting.max_depth << std::endl
 					<< "    ab_prune_enabled: " << _setting.ab_prune_enabled << std::endl
+					<< "    thread_count: " << _setting.thread_count << std::endl
+					<< "    move_ordering: " << bool(_func.ActionPriority) << std::endl
+					<< "    quiescence_depth: " << (quiescence_enabled() ? _setting.quiescence_depth : 0) << std::endl
+					<< "    transposition_table: " << _tt.info() << std::endl
 					<< "}" << std::endl;
 				return ss.str();
 			}
@@ -262,40 +544,141 @@ namespace gadt
 				return _log_controller.json_output_enabled();
 			}
 
-			//convert minimax node to visual node.
-			void MinimaxNodeToVisualNode(const Node& node, VisualNodePtr visual_node)
+			//convert state of a node to visual node.
+			void StateToVisualNode(const State& state, size_t depth, AgentIndex winner, VisualNodePtr visual_node)
 			{
 				static constexpr const char* STATE_NAME = "state";
 				static constexpr const char* DEPTH_NAME = "depth";
 				static constexpr const char* WINNER_NAME = "winner";
 				static constexpr const char* IS_TERMINAL_STATE_NAME = "is_terminal_state";
 
-				visual_node->add_value(STATE_NAME, _log_controller.state_to_str_func()(node.state()));
-				visual_node->add_value(DEPTH_NAME, node.depth());
-				visual_node->add_value(WINNER_NAME, node.winner());
-				visual_node->add_value(IS_TERMINAL_STATE_NAME, node.is_terminal_state());
+				visual_node->add_value(STATE_NAME, _log_controller.state_to_str_func()(state));
+				visual_node->add_value(DEPTH_NAME, depth);
+				visual_node->add_value(WINNER_NAME, winner);
+				visual_node->add_value(IS_TERMINAL_STATE_NAME, winner != _setting.no_winner_index);
+			}
+
+			//return true if states are changed in place by ApplyAction and UndoAction.
+			inline bool in_place_enabled() const
+			{
+				return _func.ApplyAction && _func.UndoAction;
+			}
+
+			//get the state of the node in the ply.
+			inline State& state_at(SearchWorker& w, size_t ply) const
+			{
+				return in_place_enabled() ? w.state_stack[0] : w.state_stack[ply];
+			}
+
+			//get the worker by index, which is created if not exist.
+			SearchWorker& worker(size_t index)
+			{
+				while (_workers.size() <= index)
+				{
+					_workers.push_back(std::unique_ptr<SearchWorker>(new SearchWorker(_workers.size())));
+				}
+				return *_workers[index];
+			}
+
+			//prepare the worker before search, memory is only allocated if the stacks are not large enough.
+			void PrepareWorker(SearchWorker& w, const State& root_state)
+			{
+				const size_t max_depth = _setting.max_depth + (quiescence_enabled() ? _setting.quiescence_depth : 0);
+				if (w.state_stack.size() < max_depth + 1)
+				{
+					w.state_stack.assign(max_depth + 1, root_state);
+				}
+				else
+				{
+					w.state_stack[0] = root_state;
+				}
+				if (w.frames.size() < max_depth + 1)
+				{
+					w.frames.resize(max_depth + 1);
+				}
+				if (w.pv_table.size() < max_depth + 1)
+				{
+					w.pv_table.resize(max_depth + 1);
+				}
+				for (auto& line : w.pv_table)
+				{
+					line.clear();
+				}
+				w.prev_pv.clear();
+				w.json_enabled = w.index == 0 && json_output_enabled();
+				w.deadline.reset(_setting.timeout);
+				w.aborted = false;
+				w.node_count = 1;
+				w.leaf_node_count = 0;
+				w.tt_hit_count = 0;
+				w.completed_depth = 0;
+				w.best_action_index = 0;
+				make_actions(w, 0);
+				w.eval_set.assign(w.frames[0].actions.size(), -std::numeric_limits<EvalValue>::infinity());
+			}
+
+			//generate actions of the node in the ply.
+			inline ActionSet& make_actions(SearchWorker& w, size_t ply)
+			{
+				ActionSet& actions = w.frames[ply].actions;
+				actions.clear();
+				_func.MakeAction(state_at(w, ply), actions);
+				return actions;
+			}
+
+			//make the state of child node in next ply by the action.
+			inline void make_child(SearchWorker& w, size_t ply, const Action& action)
+			{
+				if (in_place_enabled())
+				{
+					_func.ApplyAction(w.state_stack[0], action);
+				}
+				else
+				{
+					w.state_stack[ply + 1] = _func.GetNewState(w.state_stack[ply], action);
+				}
+			}
+
+			//restore the state of the node in the ply after the child is searched.
+			inline void unmake_child(SearchWorker& w, const Action& action)
+			{
+				if (in_place_enabled())
+				{
+					_func.UndoAction(w.state_stack[0], action);
+				}
+			}
+
+			//return true if the search of the worker should stop.
+			inline bool check_abort(SearchWorker& w)
+			{
+				if (!w.aborted && (_stop.load(std::memory_order_relaxed) || w.deadline.poll_timeout()))
+				{
+					w.aborted = true;
+				}
+				return w.aborted;
 			}
 
 			//get the highest eval for parent of node.
-			EvalValue NegamaxEvalForParents(const Node& node, VisualNodePtr parent_visual_node, size_t& leaf_node_count)
+			EvalValue NegamaxEvalForParents(SearchWorker& w, size_t ply, size_t depth, VisualNodePtr parent_visual_node)
 			{
-				
 				VisualNodePtr visual_node = nullptr;
-				const size_t original_leaf_node_count = leaf_node_count;
+				const size_t original_leaf_node_count = w.leaf_node_count;
+				const AgentIndex winner = _func.DetemineWinner(state_at(w, ply));
+				w.node_count++;
 
-				if (json_output_enabled())
+				if (w.json_enabled)
 				{
 					visual_node = parent_visual_node->create_child();
-					MinimaxNodeToVisualNode(node, visual_node);
+					StateToVisualNode(state_at(w, ply), depth, winner, visual_node);
 				}
 
-				if (node.depth() == 0 || node.is_terminal_state())
+				if (depth == 0 || winner != _setting.no_winner_index)
 				{
 					//get the eavl of the parent node.
-					leaf_node_count++;
-					EvalValue eval = _func.EvalForParent(node.state(), node.winner());
+					w.leaf_node_count++;
+					EvalValue eval = _func.EvalForParent(state_at(w, ply), winner);
 
-					if (json_output_enabled())
+					if (w.json_enabled)
 					{
 						visual_node->add_value("eval", eval);
 					}
@@ -303,140 +686,632 @@ namespace gadt
 					return eval;
 				}
 
+				const ActionSet& actions = make_actions(w, ply);
 				if (is_debug())
 				{
-					GADT_CHECK_WARNING(g_MINIMAX_ENABLE_WARNING, node.action_set().size() == 0, "MM101: empty action set");
+					GADT_CHECK_WARNING(g_MINIMAX_ENABLE_WARNING, actions.size() == 0, "MM101: empty action set");
 				}
 				
 				//pick up best value in child nodes.
-				Node first_child(node.state(), node.action_set()[0], node.depth() - 1, _func,_setting);
-				EvalValue best_value = NegamaxEvalForParents(first_child, visual_node, leaf_node_count);
-				for (size_t i = 1; i < node.action_set().size(); i++)
+				EvalValue best_value = -std::numeric_limits<EvalValue>::infinity();
+				for (const Action& action : actions)
 				{
-					Node child(node.state(), node.action_set()[i], node.depth() - 1, _func, _setting);
-					EvalValue child_value = NegamaxEvalForParents(child, visual_node, leaf_node_count);
+					make_child(w, ply, action);
+					EvalValue child_value = NegamaxEvalForParents(w, ply + 1, depth - 1, visual_node);
+					unmake_child(w, action);
 					if (child_value >= best_value) { best_value = child_value; }
 				}
 
-				if (json_output_enabled())
+				if (w.json_enabled)
 				{
-					visual_node->add_value("leaf node count", leaf_node_count - original_leaf_node_count);
+					visual_node->add_value("leaf node count", w.leaf_node_count - original_leaf_node_count);
 					visual_node->add_value("value for parent", -best_value);
 				}
 				return -best_value;
 			}
 
-		public:
-			//constructor func.
-			MinimaxSearch(
-				typename FuncPackage::GetNewStateFunc		GetNewState,
-				typename FuncPackage::MakeActionFunc		MakeAction,
-				typename FuncPackage::DetemineWinnerFunc	DetemineWinner,
-				typename FuncPackage::EvalForParentFunc		EvalForParent
-			):
-				_func(GetNewState,MakeAction,DetemineWinner,EvalForParent),
-				_setting(),
-				_log_controller()
+			//get the order of actions in the node of the ply, actions are sorted by priority if move ordering is enabled.
+			//the action of principal variation is always searched first, and the best action in transposition table is searched next.
+			//helper threads rotate the order of root actions for diversity.
+			const std::vector<size_t>& OrderActions(SearchWorker& w, size_t ply, size_t pv_index, size_t tt_index)
 			{
+				const ActionSet& actions = w.frames[ply].actions;
+				std::vector<size_t>& order = w.frames[ply].order;
+				order.resize(actions.size());
+				for (size_t i = 0; i < order.size(); i++)
+				{
+					order[i] = i;
+				}
+				if (_func.ActionPriority)
+				{
+					std::vector<EvalValue>& priority = w.frames[ply].priority;
+					priority.resize(actions.size());
+					for (size_t i = 0; i < actions.size(); i++)
+					{
+						priority[i] = _func.ActionPriority(state_at(w, ply), actions[i], ply);
+					}
+					std::stable_sort(order.begin(), order.end(), [&priority](size_t a, size_t b)->bool {
+						return priority[a] > priority[b];
+					});
+				}
+				if (ply == 0 && w.index != 0 && order.size() > 1)
+				{
+					std::rotate(order.begin(), order.begin() + (w.index % order.size()), order.end());
+				}
+				for (size_t first : { tt_index, pv_index })
+				{
+					if (first < order.size())
+					{
+						auto iter = std::find(order.begin(), order.end(), first);
+						std::rotate(order.begin(), iter, iter + 1);
+					}
+				}
+				return order;
 			}
 
-			//excute nega minimax search
-			Action DoNegamax(const State& state, MinimaxSetting setting = MinimaxSetting())
+			//return true if transposition table is used.
+			inline bool tt_enabled() const
 			{
-				_setting = setting;
-				Node root(state, _func, _setting);
-				VisualNodePtr root_visual_node = nullptr;
+				return _tt.enabled() && _func.StateHash;
+			}
 
-				if (is_debug())
+			//get the action index of last principal variation in the ply if the node is on it.
+			inline size_t pv_index(const SearchWorker& w, size_t ply, bool on_pv) const
+			{
+				return on_pv && ply < w.prev_pv.size() ? w.prev_pv[ply] : _no_pv_index;
+			}
+
+			//update principal variation of the ply by the best action and the variation of its child.
+			inline void update_pv(SearchWorker& w, size_t ply, size_t index)
+			{
+				std::vector<size_t>& line = w.pv_table[ply];
+				line.clear();
+				line.push_back(index);
+				if (ply + 1 < w.pv_table.size())
 				{
-					GADT_CHECK_WARNING(g_MINIMAX_ENABLE_WARNING, root.is_terminal_state(), "MM102: execute search for terminal state.");
+					const std::vector<size_t>& child_line = w.pv_table[ply + 1];
+					line.insert(line.end(), child_line.begin(), child_line.end());
 				}
+			}
 
-				if (log_enabled())
+			//get the eval for parent of node by alpha-beta pruning, alpha and beta are the bounds for the parent.
+			//the search is fail-soft, which means the returned value may be outside the bounds.
+			//on_pv is true if the node is on the principal variation of last iteration.
+			EvalValue AlphaBetaEvalForParents(SearchWorker& w, size_t ply, size_t depth, EvalValue alpha, EvalValue beta, bool on_pv, VisualNodePtr parent_visual_node)
+			{
+				VisualNodePtr visual_node = nullptr;
+				w.node_count++;
+				w.pv_table[ply].clear();
+
+				//stop search if timeout, the value is useless since the iteration would be dropped.
+				if (check_abort(w))
 				{
-					logger() << ">> Minimax Search start" << std::endl;
+					return 0;
 				}
 
-				if (json_output_enabled())
+				const AgentIndex winner = _func.DetemineWinner(state_at(w, ply));
+				if (w.json_enabled)
 				{
-					root_visual_node = _log_controller.visual_tree().root_node();
+					visual_node = parent_visual_node->create_child();
+					StateToVisualNode(state_at(w, ply), depth, winner, visual_node);
 				}
 
-				std::vector<EvalValue> eval_set(root.action_set().size());
-				size_t leaf_node_count = 0;
+				if (depth == 0 && winner == _setting.no_winner_index && quiescence_enabled())
+				{
+					//resolve noisy actions before the node is evaluated.
+					return QuiescenceEvalForParents(w, ply, _setting.quiescence_depth, alpha, beta, visual_node);
+				}
 
-				//pick up best action.
-				Node first_child(state, root.action_set()[0], root.depth() - 1, _func, _setting);
-				EvalValue best_value = NegamaxEvalForParents(first_child, root_visual_node, leaf_node_count);
-				eval_set[0] = best_value;
-				size_t best_action_index = 0;
-				for (size_t i = 1; i < root.action_set().size(); i++)
+				if (depth == 0 || winner != _setting.no_winner_index)
 				{
-					Node child(state, root.action_set()[i], root.depth() - 1, _func, _setting);
-					eval_set[i] = NegamaxEvalForParents(child, root_visual_node, leaf_node_count);
-					
-					if (eval_set[i] > best_value)
+					//get the eavl of the parent node.
+					w.leaf_node_count++;
+					EvalValue eval = _func.EvalForParent(state_at(w, ply), winner);
+
+					if (w.json_enabled)
 					{
-						best_action_index = i;
-						best_value = eval_set[i];
+						visual_node->add_value("eval", eval);
 					}
+
+					return eval;
 				}
-				
 
-				if (log_enabled())
+				const ActionSet& actions = make_actions(w, ply);
+				if (is_debug())
 				{
-					table::ConsoleTable tb(4, root.action_set().size() + 1);
-					tb.set_cell_in_row(0, { {"Index" }, {"Action"},{"Eval"},{"Is Best"} });
-					tb.set_width({ 3,10,4,4 });
-					for (size_t i = 0; i < root.action_set().size(); i++)
+					GADT_CHECK_WARNING(g_MINIMAX_ENABLE_WARNING, actions.size() == 0, "MM101: empty action set");
+				}
+
+				//the bounds for the player of this node.
+				EvalValue node_alpha = -beta;
+				const EvalValue node_beta = -alpha;
+				const EvalValue original_alpha = node_alpha;
+
+				//probe transposition table.
+				uint64_t key = 0;
+				size_t tt_index = _no_pv_index;
+				if (tt_enabled())
+				{
+					key = _func.StateHash(state_at(w, ply));
+					TranspositionEntry entry;
+					if (_tt.probe(key, entry) && entry.best_index < actions.size())
 					{
-						tb.set_cell_in_row(i + 1, {
-							{ console::IntergerToString(i) },
-							{ _log_controller.action_to_str_func()(root.action_set()[i])},
-							{ console::DoubleToString(eval_set[i])},
-							{ i == best_action_index ? "Y ":"  "}
-						});
+						w.tt_hit_count++;
+						tt_index = entry.best_index;
+						if (entry.depth >= depth && (
+							entry.bound == EXACT_BOUND ||
+							(entry.bound == LOWER_BOUND && entry.value >= node_beta) ||
+							(entry.bound == UPPER_BOUND && entry.value <= node_alpha)))
+						{
+							return -entry.value;
+						}
 					}
-					logger() << tb.output_string(true, false) << std::endl;
 				}
 
-				if (json_output_enabled())
+				EvalValue best_value = -std::numeric_limits<EvalValue>::infinity();
+				size_t best_index = 0;
+				const size_t node_pv_index = pv_index(w, ply, on_pv);
+				for (size_t index : OrderActions(w, ply, node_pv_index, tt_index))
 				{
-					root_visual_node->add_value("leaf node count", leaf_node_count);
-					_log_controller.OutputJson();
+					make_child(w, ply, actions[index]);
+					EvalValue child_value = AlphaBetaEvalForParents(w, ply + 1, depth - 1, node_alpha, node_beta, index == node_pv_index, visual_node);
+					unmake_child(w, actions[index]);
+					if (w.aborted)
+					{
+						return 0;
+					}
+					if (child_value > best_value)
+					{
+						best_value = child_value;
+						best_index = index;
+						update_pv(w, ply, index);
+						if (best_value > node_alpha) { node_alpha = best_value; }
+						if (node_alpha >= node_beta)
+						{
+							//cut off.
+							if (_func.RecordCutoff)
+							{
+								_func.RecordCutoff(state_at(w, ply), actions[index], ply, depth);
+							}
+							break;
+						}
+					}
 				}
 
-				//return best action.
-				return root.action_set()[best_action_index];
-			}
+				if (tt_enabled())
+				{
+					BoundType bound = EXACT_BOUND;
+					if (best_value <= original_alpha) { bound = UPPER_BOUND; }
+					else if (best_value >= node_beta) { bound = LOWER_BOUND; }
+					_tt.store(key, best_value, depth, bound, best_index);
+				}
 
-			//TODO
-			//excute alpha-beta search.
-			Action DoAlphaBeta(const State& state, MinimaxSetting setting = MinimaxSetting())
-			{
-				_setting = setting;
+				if (w.json_enabled)
+				{
+					visual_node->add_value("value for parent", -best_value);
+				}
+				return -best_value;
 			}
 
-			//enable log
-			void InitLog(typename LogController::StateToStrFunc StateToStr, typename LogController::ActionToStrFunc ActionToStr)
+			//return true if quiescence search is enabled.
+			inline bool quiescence_enabled() const
 			{
-				_log_controller.Init(StateToStr, ActionToStr);
+				return _func.MakeQuiescenceAction && _setting.quiescence_depth > 0;
 			}
 
-			//enable log by ostream.
-			inline void EnableLog(std::ostream& os = std::cout)
+			//get the eval for parent of node by quiescence search, which only searchs noisy actions until the node is quiet.
+			//the player of the node can stand pat by its static eval, so EvalForParent must be a reasonable eval for non-terminal states.
+			//actions that can not raise the value above alpha even with their max gain are skipped by delta pruning.
+			EvalValue QuiescenceEvalForParents(SearchWorker& w, size_t ply, size_t depth, EvalValue alpha, EvalValue beta, VisualNodePtr visual_node)
 			{
-				_log_controller.EnableLog(os);
+				w.leaf_node_count++;
+
+				const AgentIndex winner = _func.DetemineWinner(state_at(w, ply));
+				const EvalValue eval = _func.EvalForParent(state_at(w, ply), winner);
+				if (w.json_enabled && visual_node != nullptr)
+				{
+					visual_node->add_value("quiescence eval", eval);
+				}
+				if (depth == 0 || winner != _setting.no_winner_index)
+				{
+					return eval;
+				}
+
+				//stand pat.
+				EvalValue node_alpha = -beta;
+				const EvalValue node_beta = -alpha;
+				EvalValue best_value = -eval;
+				if (best_value >= node_beta)
+				{
+					return -best_value;
+				}
+				if (best_value > node_alpha) { node_alpha = best_value; }
+
+				ActionSet& actions = w.frames[ply].actions;
+				actions.clear();
+				_func.MakeQuiescenceAction(state_at(w, ply), actions);
+				for (size_t index : OrderActions(w, ply, _no_pv_index, _no_pv_index))
+				{
+					//delta pruning.
+					if (_func.ActionGain && best_value + _func.ActionGain(state_at(w, ply), actions[index]) + _setting.delta_margin <= node_alpha)
+					{
+						continue;
+					}
+
+					w.node_count++;
+					make_child(w, ply, actions[index]);
+					EvalValue child_value = QuiescenceEvalForParents(w, ply + 1, depth - 1, node_alpha, node_beta, nullptr);
+					unmake_child(w, actions[index]);
+					if (check_abort(w))
+					{
+						return 0;
+					}
+					if (child_value > best_value)
+					{
+						best_value = child_value;
+						if (best_value > node_alpha) { node_alpha = best_value; }
+						if (node_alpha >= node_beta) { break; }//cut off.
+					}
+				}
+				return -best_value;
 			}
 
-			//disable log.
-			inline void DisableLog()
+			//search all root actions by alpha-beta in the depth, return false if the iteration is aborted.
+			bool AlphaBetaIteration(SearchWorker& w, size_t depth, std::vector<EvalValue>& eval_set, size_t& best_action_index, VisualNodePtr visual_node)
 			{
-				_log_controller.DisableLog();
+				const ActionSet& actions = w.frames[0].actions;
+				const size_t root_pv_index = pv_index(w, 0, true);
+				w.pv_table[0].clear();
+
+				//pick up best action, evals of actions that are not the best are upper bounds.
+				EvalValue best_value = -std::numeric_limits<EvalValue>::infinity();
+				for (size_t index : OrderActions(w, 0, root_pv_index, _no_pv_index))
+				{
+					make_child(w, 0, actions[index]);
+					EvalValue child_value = AlphaBetaEvalForParents(w, 1, depth - 1, best_value, std::numeric_limits<EvalValue>::infinity(), index == root_pv_index, visual_node);
+					unmake_child(w, actions[index]);
+					if (w.aborted)
+					{
+						return false;
+					}
+					eval_set[index] = child_value;
+					if (child_value > best_value)
+					{
+						best_action_index = index;
+						best_value = child_value;
+						update_pv(w, 0, index);
+					}
+				}
+				return true;
 			}
 
-			//enable json output
-			inline void EnableJsonOutput(std::string output_path = "./MinimaxOutput.json")
+			//deepen the search of the worker until max depth or abort, helper threads start from different depth.
+			void IterativeDeepening(SearchWorker& w, VisualNodePtr root_visual_node)
+			{
+				const ActionSet& actions = w.frames[0].actions;
+				std::vector<EvalValue> iteration_eval_set(actions.size());
+				const size_t start_depth = 1 + (w.index % 2);
+				for (size_t depth = start_depth <= _setting.max_depth ? start_depth : 1; depth <= _setting.max_depth; depth++)
+				{
+					VisualNodePtr iteration_visual_node = nullptr;
+					if (w.json_enabled)
+					{
+						iteration_visual_node = root_visual_node->create_child();
+						iteration_visual_node->add_value("iteration depth", depth);
+					}
+
+					size_t iteration_best_index = 0;
+					std::fill(iteration_eval_set.begin(), iteration_eval_set.end(), -std::numeric_limits<EvalValue>::infinity());
+					if (!AlphaBetaIteration(w, depth, iteration_eval_set, iteration_best_index, iteration_visual_node))
+					{
+						//drop the unfinished iteration, unless no iteration is completed.
+						if (w.completed_depth == 0)
+						{
+							w.best_action_index = iteration_best_index;
+							w.eval_set = iteration_eval_set;
+						}
+						break;
+					}
+
+					w.completed_depth = depth;
+					w.best_action_index = iteration_best_index;
+					w.eval_set = iteration_eval_set;
+					w.prev_pv = w.pv_table[0];
+
+					if (log_enabled() && w.index == 0)
+					{
+						logger() << ">> depth " << depth << " finished, best action: " << _log_controller.action_to_str_func()(actions[w.best_action_index])
+							<< ", eval: " << w.eval_set[w.best_action_index] << ", node count: " << w.node_count
+							<< ", time: " << w.deadline.time_since_created() << "s" << std::endl;
+					}
+				}
+			}
+
+			//output evals of root actions.
+			void LogRootEvals(const ActionSet& actions, const std::vector<EvalValue>& eval_set, size_t best_action_index)
+			{
+				table::ConsoleTable tb(4, actions.size() + 1);
+				tb.set_cell_in_row(0, { {"Index" }, {"Action"},{"Eval"},{"Is Best"} });
+				tb.set_width({ 3,10,4,4 });
+				for (size_t i = 0; i < actions.size(); i++)
+				{
+					tb.set_cell_in_row(i + 1, {
+						{ console::IntergerToString(i) },
+						{ _log_controller.action_to_str_func()(actions[i])},
+						{ console::DoubleToString(eval_set[i])},
+						{ i == best_action_index ? "Y ":"  "}
+					});
+				}
+				logger() << tb.output_string(true, false) << std::endl;
+			}
+
+		public:
+			//constructor func.
+			MinimaxSearch(
+				typename FuncPackage::GetNewStateFunc		GetNewState,
+				typename FuncPackage::MakeActionFunc		MakeAction,
+				typename FuncPackage::DetemineWinnerFunc	DetemineWinner,
+				typename FuncPackage::EvalForParentFunc		EvalForParent
+			):
+				_func(GetNewState,MakeAction,DetemineWinner,EvalForParent),
+				_setting(),
+				_log_controller(),
+				_node_count(0),
+				_leaf_node_count(0),
+				_tt(),
+				_workers(),
+				_stop(false)
+			{
+			}
+
+			//excute nega minimax search, alpha-beta search would be excuted if ab_prune_enabled is true.
+			Action DoNegamax(const State& state, MinimaxSetting setting = MinimaxSetting())
+			{
+				if (setting.ab_prune_enabled)
+				{
+					return DoAlphaBeta(state, setting);
+				}
+
+				_setting = setting;
+				_stop = false;
+				SearchWorker& w = worker(0);
+				PrepareWorker(w, state);
+				const ActionSet& actions = w.frames[0].actions;
+				VisualNodePtr root_visual_node = nullptr;
+
+				if (is_debug())
+				{
+					GADT_CHECK_WARNING(g_MINIMAX_ENABLE_WARNING, _func.DetemineWinner(state) != _setting.no_winner_index, "MM102: execute search for terminal state.");
+				}
+
+				if (log_enabled())
+				{
+					logger() << ">> Minimax Search start" << std::endl;
+				}
+
+				if (json_output_enabled())
+				{
+					root_visual_node = _log_controller.visual_tree().root_node();
+				}
+
+				std::vector<EvalValue>& eval_set = w.eval_set;
+
+				//pick up best action.
+				EvalValue best_value = -std::numeric_limits<EvalValue>::infinity();
+				size_t best_action_index = 0;
+				size_t searched_action_count = 0;
+				for (size_t i = 0; i < actions.size(); i++)
+				{
+					//stop search if timeout, the best action in searched actions would be returned.
+					if (i > 0 && w.deadline.poll_timeout())
+					{
+						break;
+					}
+
+					make_child(w, 0, actions[i]);
+					eval_set[i] = NegamaxEvalForParents(w, 1, _setting.max_depth - 1, root_visual_node);
+					unmake_child(w, actions[i]);
+					searched_action_count++;
+					
+					if (eval_set[i] > best_value)
+					{
+						best_action_index = i;
+						best_value = eval_set[i];
+					}
+				}
+
+				if (log_enabled() && searched_action_count < actions.size())
+				{
+					logger() << ">> Minimax Search timeout, " << searched_action_count << "/" << actions.size() << " actions searched" << std::endl;
+				}
+				
+
+				if (log_enabled())
+				{
+					LogRootEvals(actions, eval_set, best_action_index);
+				}
+
+				if (json_output_enabled())
+				{
+					root_visual_node->add_value("leaf node count", w.leaf_node_count);
+					_log_controller.OutputJson();
+				}
+
+				_node_count = w.node_count;
+				_leaf_node_count = w.leaf_node_count;
+
+				//return best action.
+				return actions[best_action_index];
+			}
+
+			//excute alpha-beta search with iterative deepening, the result of last completed depth would be returned if timeout.
+			Action DoAlphaBeta(const State& state, MinimaxSetting setting = MinimaxSetting())
+			{
+				_setting = setting;
+				_stop = false;
+				_tt.new_search();
+				const size_t thread_count = _setting.thread_count > 0 ? _setting.thread_count : 1;
+				for (size_t i = 0; i < thread_count; i++)
+				{
+					PrepareWorker(worker(i), state);
+				}
+				SearchWorker& main_worker = worker(0);
+				const ActionSet& actions = main_worker.frames[0].actions;
+				VisualNodePtr root_visual_node = nullptr;
+
+				if (is_debug())
+				{
+					GADT_CHECK_WARNING(g_MINIMAX_ENABLE_WARNING, _func.DetemineWinner(state) != _setting.no_winner_index, "MM102: execute search for terminal state.");
+				}
+
+				if (log_enabled())
+				{
+					logger() << ">> Alpha-Beta Search start" << std::endl;
+				}
+
+				if (json_output_enabled())
+				{
+					root_visual_node = _log_controller.visual_tree().root_node();
+				}
+
+				//helper threads search until the main thread finishes.
+				std::vector<std::thread> helpers;
+				for (size_t i = 1; i < thread_count; i++)
+				{
+					SearchWorker* helper = &worker(i);
+					helpers.push_back(std::thread([this, helper]() { IterativeDeepening(*helper, nullptr); }));
+				}
+				IterativeDeepening(main_worker, root_visual_node);
+				_stop = true;
+				for (auto& t : helpers)
+				{
+					t.join();
+				}
+
+				//pick up the result of the deepest completed iteration.
+				const SearchWorker* best_worker = &main_worker;
+				_node_count = 0;
+				_leaf_node_count = 0;
+				size_t tt_hit_count = 0;
+				for (size_t i = 0; i < thread_count; i++)
+				{
+					const SearchWorker& w = *_workers[i];
+					_node_count += w.node_count;
+					_leaf_node_count += w.leaf_node_count;
+					tt_hit_count += w.tt_hit_count;
+					if (w.completed_depth > best_worker->completed_depth)
+					{
+						best_worker = &w;
+					}
+				}
+				const size_t completed_depth = best_worker->completed_depth;
+				const size_t best_action_index = best_worker->best_action_index;
+
+				if (log_enabled())
+				{
+					if (completed_depth < _setting.max_depth)
+					{
+						logger() << ">> Alpha-Beta Search timeout, completed depth = " << completed_depth << std::endl;
+					}
+					if (thread_count > 1)
+					{
+						logger() << ">> threads = " << thread_count << ", result from thread " << best_worker->index << std::endl;
+					}
+					logger() << ">> node count = " << _node_count << ", leaf node count = " << _leaf_node_count << std::endl;
+					if (tt_enabled())
+					{
+						logger() << ">> transposition table = " << _tt.info() << ", hit = " << tt_hit_count << std::endl;
+					}
+					LogRootEvals(actions, best_worker->eval_set, best_action_index);
+				}
+
+				if (json_output_enabled())
+				{
+					root_visual_node->add_value("completed depth", completed_depth);
+					root_visual_node->add_value("node count", _node_count);
+					root_visual_node->add_value("leaf node count", _leaf_node_count);
+					_log_controller.OutputJson();
+				}
+
+				//return best action.
+				return actions[best_action_index];
+			}
+
+			//get the principal variation of last completed iteration of main thread, saved as indexes of actions in each ply.
+			inline const std::vector<size_t>& principal_variation() const
+			{
+				static const std::vector<size_t> empty_pv;
+				return _workers.empty() ? empty_pv : _workers[0]->prev_pv;
+			}
+
+			//set the function that get the priority of actions, which enables move ordering in alpha-beta search.
+			//RecordCutoff is optional, which is called when an action causes a cut off.
+			inline void InitOrdering(typename FuncPackage::ActionPriorityFunc ActionPriority, typename FuncPackage::RecordCutoffFunc RecordCutoff = nullptr)
+			{
+				_func.ActionPriority = ActionPriority;
+				_func.RecordCutoff = RecordCutoff;
+			}
+
+			//set the functions that make and unmake action in place, which avoid copying states in search.
+			inline void InitInPlace(typename FuncPackage::ApplyActionFunc ApplyAction, typename FuncPackage::UndoActionFunc UndoAction)
+			{
+				_func.ApplyAction = ApplyAction;
+				_func.UndoAction = UndoAction;
+			}
+
+			//set the function that create noisy actions, which enables quiescence search at the leaves of alpha-beta search.
+			//ActionGain is optional, which enables delta pruning.
+			inline void InitQuiescence(typename FuncPackage::MakeQuiescenceActionFunc MakeQuiescenceAction, typename FuncPackage::ActionGainFunc ActionGain = nullptr)
+			{
+				_func.MakeQuiescenceAction = MakeQuiescenceAction;
+				_func.ActionGain = ActionGain;
+			}
+
+			//enable transposition table by the hash function of state and memory size in MB.
+			inline void InitTranspositionTable(typename FuncPackage::StateHashFunc StateHash, size_t memory_mb)
+			{
+				_func.StateHash = StateHash;
+				_tt.resize(memory_mb);
+			}
+
+			//get the transposition table.
+			inline TranspositionTable& transposition_table()
+			{
+				return _tt;
+			}
+
+			//get the number of nodes visited in last search.
+			inline size_t node_count() const
+			{
+				return _node_count;
+			}
+
+			//get the number of leaf nodes evaluated in last search.
+			inline size_t leaf_node_count() const
+			{
+				return _leaf_node_count;
+			}
+
+			//enable log
+			void InitLog(typename LogController::StateToStrFunc StateToStr, typename LogController::ActionToStrFunc ActionToStr)
+			{
+				_log_controller.Init(StateToStr, ActionToStr);
+			}
+
+			//enable log by ostream.
+			inline void EnableLog(std::ostream& os = std::cout)
+			{
+				_log_controller.EnableLog(os);
+			}
+
+			//disable log.
+			inline void DisableLog()
+			{
+				_log_controller.DisableLog();
+			}
+
+			//enable json output
+			inline void EnableJsonOutput(std::string output_path = "./MinimaxOutput.json")
 			{
 				_log_controller.EnableJsonOutput(output_path);
 			}
@@ -451,6 +1326,11 @@ namespace gadt
 		/*
 		* ExpectimaxSearch is a template of Expectimax search.
 		*
+		* a state is a chance node if MakeChanceOutcome returns any outcome, whose child states are created by GetNewState with
+		* the outcome actions. chance nodes neither change the view of values nor consume search depth. decision nodes are
+		* searched by fail-soft alpha-beta. if both eval_lower_bound and eval_upper_bound in setting are finite, chance nodes
+		* are pruned by Star1, and Star2 probes the first action of every outcome before the full search.
+		*
 		* [State] is the game-state class, which is defined by the user.
 		* [Action] is the game-action class, which is defined by the user.
 		* [_is_debug] means some debug info would not be ignored if it is true. this may result in a little degradation of performance.
@@ -458,7 +1338,375 @@ namespace gadt
 		template<typename State, typename Action, bool _is_debug = false>
 		class ExpectimaxSearch
 		{
-			//TODO
+		public:
+			using ActionSet		= std::vector<Action>;
+			using ChanceOutcome	= std::pair<Action, double>;		//outcome action and its probability.
+			using ChanceSet		= std::vector<ChanceOutcome>;
+			using LogController	= log::SearchLogger<State, Action>;
+
+			struct FuncPackage
+			{
+			public:
+				using GetNewStateFunc = std::function<State(const State&, const Action&)>;
+				using MakeActionFunc = std::function<void(const State&, ActionSet&)>;
+				using DetemineWinnerFunc = std::function<AgentIndex(const State&)>;
+				using EvalForParentFunc = std::function<EvalValue(const State&, const AgentIndex)>;
+				using MakeChanceOutcomeFunc = std::function<void(const State&, ChanceSet&)>;
+
+			public:
+				//necessary functions.
+				const GetNewStateFunc		GetNewState;		//get a new state from previous state and action.
+				const MakeActionFunc		MakeAction;			//the function which create action set by the state.
+				const DetemineWinnerFunc	DetemineWinner;		//return no_winner_index if a state is not terminal state.
+				const EvalForParentFunc		EvalForParent;		//get the eval for parent node.
+				const MakeChanceOutcomeFunc	MakeChanceOutcome;	//create outcomes of a chance state, leave it empty if the state is a decision state.
+
+			public:
+				FuncPackage(
+					GetNewStateFunc			_GetNewState,
+					MakeActionFunc			_MakeAction,
+					DetemineWinnerFunc		_DetemineWinner,
+					EvalForParentFunc		_EvalForParent,
+					MakeChanceOutcomeFunc	_MakeChanceOutcome
+				) :
+					GetNewState(_GetNewState),
+					MakeAction(_MakeAction),
+					DetemineWinner(_DetemineWinner),
+					EvalForParent(_EvalForParent),
+					MakeChanceOutcome(_MakeChanceOutcome)
+				{
+				}
+			};
+
+		private:
+			FuncPackage		_func;
+			MinimaxSetting	_setting;
+			LogController	_log_controller;
+			timer::Deadline	_deadline;
+			bool			_search_aborted;
+			size_t			_node_count;		//the number of nodes visited in last search.
+			size_t			_leaf_node_count;	//the number of leaf nodes evaluated in last search.
+			size_t			_chance_cut_count;	//the number of chance nodes pruned by Star1/Star2 in last search.
+
+		private:
+			//return true if is debug.
+			constexpr bool is_debug() const
+			{
+				return _is_debug;
+			}
+
+			//get reference of log ostream
+			inline std::ostream& logger()
+			{
+				return _log_controller.log_ostream();
+			}
+
+			//return true if log enabled.
+			inline bool log_enabled() const
+			{
+				return _log_controller.log_enabled();
+			}
+
+			//return true if Star1/Star2 pruning is available.
+			inline bool star_enabled() const
+			{
+				return _setting.eval_bounded();
+			}
+
+			//get the eval for parent of the state, alpha and beta are the bounds for the parent.
+			EvalValue EvalForParents(const State& state, size_t depth, EvalValue alpha, EvalValue beta)
+			{
+				_node_count++;
+				if (_search_aborted || _deadline.poll_timeout())
+				{
+					_search_aborted = true;
+					return 0;
+				}
+
+				ChanceSet outcomes;
+				_func.MakeChanceOutcome(state, outcomes);
+				if (!outcomes.empty())
+				{
+					return ChanceEvalForParents(state, outcomes, depth, alpha, beta);
+				}
+
+				AgentIndex winner = _func.DetemineWinner(state);
+				if (depth == 0 || winner != _setting.no_winner_index)
+				{
+					_leaf_node_count++;
+					return _func.EvalForParent(state, winner);
+				}
+
+				ActionSet actions;
+				_func.MakeAction(state, actions);
+				if (is_debug())
+				{
+					GADT_CHECK_WARNING(g_MINIMAX_ENABLE_WARNING, actions.size() == 0, "MM101: empty action set");
+				}
+
+				//the bounds for the player of this node.
+				EvalValue node_alpha = -beta;
+				const EvalValue node_beta = -alpha;
+				EvalValue best_value = -std::numeric_limits<EvalValue>::infinity();
+				for (const Action& action : actions)
+				{
+					EvalValue child_value = EvalForParents(_func.GetNewState(state, action), depth - 1, node_alpha, node_beta);
+					if (_search_aborted)
+					{
+						return 0;
+					}
+					if (child_value > best_value)
+					{
+						best_value = child_value;
+						if (best_value > node_alpha) { node_alpha = best_value; }
+						if (node_alpha >= node_beta) { break; }//cut off.
+					}
+				}
+				return -best_value;
+			}
+
+			//get the upper bound of eval for parent of the state by searching its first action only, which is the probe of Star2.
+			//the probe stops once the bound is proved to be no more than threshold.
+			EvalValue ProbeUpperBound(const State& state, size_t depth, EvalValue threshold)
+			{
+				const EvalValue lower = _setting.eval_lower_bound;
+				const EvalValue upper = _setting.eval_upper_bound;
+				if (threshold < lower || threshold >= upper)
+				{
+					return upper;//the probe can not make a cut off.
+				}
+
+				ChanceSet outcomes;
+				_func.MakeChanceOutcome(state, outcomes);
+				AgentIndex winner = _func.DetemineWinner(state);
+				if (!outcomes.empty() || depth == 0 || winner != _setting.no_winner_index)
+				{
+					return upper;
+				}
+
+				ActionSet actions;
+				_func.MakeAction(state, actions);
+				if (actions.empty())
+				{
+					return upper;
+				}
+
+				//the value of the first action is a lower bound for the player of this node.
+				const EvalValue probe_alpha = -upper;
+				EvalValue first_value = EvalForParents(_func.GetNewState(state, actions[0]), depth - 1, probe_alpha, -threshold);
+				return first_value > probe_alpha ? -first_value : upper;
+			}
+
+			//get the eval for parent of a chance state, which is the expectation of its outcomes.
+			EvalValue ChanceEvalForParents(const State& state, const ChanceSet& outcomes, size_t depth, EvalValue alpha, EvalValue beta)
+			{
+				double total_probability = 0;
+				for (const auto& outcome : outcomes)
+				{
+					total_probability += outcome.second;
+				}
+
+				if (!star_enabled())
+				{
+					EvalValue expectation = 0;
+					for (const auto& outcome : outcomes)
+					{
+						const EvalValue infinity = std::numeric_limits<EvalValue>::infinity();
+						expectation += outcome.second / total_probability * EvalForParents(_func.GetNewState(state, outcome.first), depth, -infinity, infinity);
+						if (_search_aborted)
+						{
+							return 0;
+						}
+					}
+					return expectation;
+				}
+
+				const EvalValue lower = _setting.eval_lower_bound;
+				const EvalValue upper = _setting.eval_upper_bound;
+
+				//Star2: probe every outcome to get an upper bound of the expectation.
+				EvalValue upper_sum = 0;
+				double remain = 1;
+				for (const auto& outcome : outcomes)
+				{
+					const double p = outcome.second / total_probability;
+					remain -= p;
+					EvalValue threshold = (alpha - upper_sum - remain * upper) / p;
+					upper_sum += p * ProbeUpperBound(_func.GetNewState(state, outcome.first), depth, threshold);
+					if (_search_aborted)
+					{
+						return 0;
+					}
+					if (upper_sum + remain * upper <= alpha)
+					{
+						_chance_cut_count++;
+						return upper_sum + remain * upper;
+					}
+				}
+
+				//Star1: search every outcome with the window that may change the expectation.
+				EvalValue sum = 0;
+				remain = 1;
+				for (const auto& outcome : outcomes)
+				{
+					const double p = outcome.second / total_probability;
+					remain -= p;
+					const EvalValue child_alpha = (alpha - sum - remain * upper) / p;
+					const EvalValue child_beta = (beta - sum - remain * lower) / p;
+					EvalValue child_value = EvalForParents(
+						_func.GetNewState(state, outcome.first), 
+						depth, 
+						child_alpha > lower ? child_alpha : lower, 
+						child_beta < upper ? child_beta : upper
+					);
+					if (_search_aborted)
+					{
+						return 0;
+					}
+					sum += p * child_value;
+					if (child_value <= child_alpha)
+					{
+						_chance_cut_count++;
+						return sum + remain * upper;//fail low.
+					}
+					if (child_value >= child_beta)
+					{
+						_chance_cut_count++;
+						return sum + remain * lower;//fail high.
+					}
+				}
+				return sum;
+			}
+
+		public:
+			//constructor func.
+			ExpectimaxSearch(
+				typename FuncPackage::GetNewStateFunc		GetNewState,
+				typename FuncPackage::MakeActionFunc		MakeAction,
+				typename FuncPackage::DetemineWinnerFunc	DetemineWinner,
+				typename FuncPackage::EvalForParentFunc		EvalForParent,
+				typename FuncPackage::MakeChanceOutcomeFunc	MakeChanceOutcome
+			) :
+				_func(GetNewState, MakeAction, DetemineWinner, EvalForParent, MakeChanceOutcome),
+				_setting(),
+				_log_controller(),
+				_deadline(0),
+				_search_aborted(false),
+				_node_count(0),
+				_leaf_node_count(0),
+				_chance_cut_count(0)
+			{
+			}
+
+			//excute expectimax search, the best action in searched actions would be returned if timeout.
+			Action DoExpectimax(const State& state, MinimaxSetting setting = MinimaxSetting())
+			{
+				_setting = setting;
+				_deadline.reset(_setting.timeout);
+				_search_aborted = false;
+				_node_count = 1;
+				_leaf_node_count = 0;
+				_chance_cut_count = 0;
+
+				ActionSet actions;
+				_func.MakeAction(state, actions);
+
+				if (is_debug())
+				{
+					ChanceSet outcomes;
+					_func.MakeChanceOutcome(state, outcomes);
+					GADT_CHECK_WARNING(g_MINIMAX_ENABLE_WARNING, !outcomes.empty(), "MM103: execute search for chance state.");
+					GADT_CHECK_WARNING(g_MINIMAX_ENABLE_WARNING, actions.size() == 0, "MM101: empty action set");
+				}
+
+				if (log_enabled())
+				{
+					logger() << ">> Expectimax Search start" << std::endl;
+				}
+
+				//pick up best action, evals of actions that are not the best are upper bounds.
+				std::vector<EvalValue> eval_set(actions.size(), -std::numeric_limits<EvalValue>::infinity());
+				EvalValue best_value = -std::numeric_limits<EvalValue>::infinity();
+				size_t best_action_index = 0;
+				size_t searched_action_count = 0;
+				for (size_t i = 0; i < actions.size(); i++)
+				{
+					EvalValue child_value = EvalForParents(_func.GetNewState(state, actions[i]), _setting.max_depth - 1, best_value, std::numeric_limits<EvalValue>::infinity());
+					if (_search_aborted)
+					{
+						break;//the unfinished action is dropped.
+					}
+					eval_set[i] = child_value;
+					searched_action_count++;
+					if (child_value > best_value)
+					{
+						best_action_index = i;
+						best_value = child_value;
+					}
+				}
+
+				if (log_enabled())
+				{
+					if (searched_action_count < actions.size())
+					{
+						logger() << ">> Expectimax Search timeout, " << searched_action_count << "/" << actions.size() << " actions searched" << std::endl;
+					}
+					logger() << ">> node count = " << _node_count << ", leaf node count = " << _leaf_node_count 
+						<< ", chance cut count = " << _chance_cut_count << std::endl;
+					table::ConsoleTable tb(4, actions.size() + 1);
+					tb.set_cell_in_row(0, { {"Index" }, {"Action"},{"Eval"},{"Is Best"} });
+					tb.set_width({ 3,10,4,4 });
+					for (size_t i = 0; i < actions.size(); i++)
+					{
+						tb.set_cell_in_row(i + 1, {
+							{ console::IntergerToString(i) },
+							{ _log_controller.action_to_str_func()(actions[i])},
+							{ console::DoubleToString(eval_set[i])},
+							{ i == best_action_index ? "Y ":"  "}
+						});
+					}
+					logger() << tb.output_string(true, false) << std::endl;
+				}
+
+				//return best action.
+				return actions[best_action_index];
+			}
+
+			//get the number of nodes visited in last search.
+			inline size_t node_count() const
+			{
+				return _node_count;
+			}
+
+			//get the number of leaf nodes evaluated in last search.
+			inline size_t leaf_node_count() const
+			{
+				return _leaf_node_count;
+			}
+
+			//get the number of chance nodes pruned in last search.
+			inline size_t chance_cut_count() const
+			{
+				return _chance_cut_count;
+			}
+
+			//enable log
+			void InitLog(typename LogController::StateToStrFunc StateToStr, typename LogController::ActionToStrFunc ActionToStr)
+			{
+				_log_controller.Init(StateToStr, ActionToStr);
+			}
+
+			//enable log by ostream.
+			inline void EnableLog(std::ostream& os = std::cout)
+			{
+				_log_controller.EnableLog(os);
+			}
+
+			//disable log.
+			inline void DisableLog()
+			{
+				_log_controller.DisableLog();
+			}
 		};
 	}
 }